@@ -4,13 +4,14 @@ setlocal
 set obj_dir="ignored_by_git/build/obj/"
 set exe_dir="ignored_by_git/build/exe/"
 set pdb_dir="ignored_by_git/build/pdb/"
+set lib_dir="ignored_by_git/build/lib/"
 
 set common_options=^
  /nologo /permissive-^
  /D"_CRT_SECURE_NO_WARNINGS" /D"_UNICODE" /D"UNICODE"^
  /Wall /WX^
  /wd"5045" /wd"4711" /wd"4668" /wd"5039" /wd"4710" /wd"4995"^
- /wd"4061" /wd"4062" /wd"5105" /wd"4820"^
+ /wd"4061" /wd"4062" /wd"5105" /wd"4820" /wd"4127" /wd"4611"^
  /Zi /Gm-^
  /Fo%obj_dir% /Fe%exe_dir% /Fd%pdb_dir%
 
@@ -19,8 +20,11 @@ set link_options=/link /INCREMENTAL:NO
 if not exist %obj_dir% mkdir %obj_dir%
 if not exist %exe_dir% mkdir %exe_dir%
 if not exist %pdb_dir% mkdir %pdb_dir%
+if not exist %lib_dir% mkdir %lib_dir%
 
 call :build ctok.c
+call :build_lib ctok.c
+call :build_lib_user lex_bytes.c
 call :build scrub_ws.c
 
 exit /B 0
@@ -40,4 +44,15 @@ call :build_cpp %~1
 ::call :build_c %~1
 exit /B 0
 
+:build_lib
+echo lib
+cl /c %~1 %common_options% /std:c++14 /TP /D"CTOK_LIB"
+lib /nologo /OUT:%lib_dir%%~n1.lib %obj_dir%%~n1.obj
+exit /B 0
+
+:build_lib_user
+echo lib user
+cl %~1 %common_options% /std:c11 /TC %link_options% %lib_dir%ctok.lib
+exit /B 0
+
 endlocal
\ No newline at end of file
@@ -1,10 +1,22 @@
 
 #include <assert.h>
+#include <setjmp.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <uchar.h>
+#include <wchar.h>
+
+#include <immintrin.h>
+
+#include "ctok.h"
+#include "id_tables.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 
 
@@ -26,18 +38,34 @@ bool Is_ws(char32_t ch)
 	return Is_hz_ws(ch) || ch == '\n' || ch == '\r';
 }
 
-size_t Leading_ones(Byte_t byte)
+uint32_t Count_trailing_zeros(uint32_t bits)
 {
-	size_t count = 0;
-	for (Byte_t mask = (1 << 7); mask; mask >>= 1)
-	{
-		if (!(byte & mask))
-			break;
+	// NOTE bits must not be zero
 
-		++count;
-	}
+	assert(bits);
+
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return index;
+#else
+	return (uint32_t)__builtin_ctz(bits);
+#endif
+}
 
-	return count;
+uint32_t Count_trailing_zeros(uint64_t bits)
+{
+	// NOTE bits must not be zero
+
+	assert(bits);
+
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return index;
+#else
+	return (uint32_t)__builtin_ctzll(bits);
+#endif
 }
 
 
@@ -64,1586 +92,4968 @@ size_t Byte_span_len(Byte_span_t span)
 
 
 
-// utf8 decode : convert a byte_span into a Ch_loc_ary
+// arena : bump allocator for everything we keep per file (file bytes, decoded chs,
+//  scrub queues, tokens). Reset_arena drops all of it at once, but keeps the biggest
+//  block, so once an arena has seen a file as big as the next one, it never mallocs.
 
-typedef struct Ch_len_t // ch + len
-{
-	char32_t ch;
-	size_t len;
-} Ch_len_t;
+// Each block starts with one of these, the bytes we hand out come right after
 
-Ch_len_t Make_ch_len(char32_t ch, size_t len)
+typedef struct Arena_block_t
 {
-	Ch_len_t result = {ch, len};
-	return result;
-}
+	Arena_block_t * prev_r; // blocks we outgrew, freed at the next reset
+	size_t cap;
+	size_t pad; // keeps what we hand out 16 byte aligned, same as malloc
+} Arena_block_t;
 
-typedef struct Ch_loc_t // ch + loc
-{
-	char32_t ch;
-	Byte_t * loc;
-} Ch_loc_t;
+static const size_t arena_block_len_min = 64 * 1024;
+
+// Where to go when the arena can not get a block. Lexing allocates from deep
+//  inside the scrub phases, so instead of every caller of Alloc_arena checking
+//  for NULL, whoever starts lexing (Lex_bytes, main) sets arena_r->oom_r and
+//  we longjmp back to it. Nothing in between owns anything but arena memory
 
-Ch_loc_t Make_ch_loc(char32_t ch, Byte_t * loc)
+typedef struct Arena_oom_t
 {
-	Ch_loc_t result = {ch, loc};
-	return result;
-}
+	jmp_buf jmp;
+} Arena_oom_t;
 
-typedef enum Mch_k // Meta ch
+Arena_block_t * Alloc_arena_block(
+	Arena_t * arena_r,
+	size_t cap)
 {
-	Mch_invalid = 0x110000, // 0x10FFFF + 1, signifies an encoding error
-	Mch_end,				// signifies the end of input bytes
-} Mch_k;
+	if (arena_r->block_cap_max && cap > arena_r->block_cap_max)
+		return NULL;
 
-Ch_len_t Decode_leading_ch(Byte_span_t span)
+	void * mem = malloc(sizeof(Arena_block_t) + cap);
+	if (!mem)
+		return NULL;
+
+	++arena_r->len_mallocs;
+
+	Arena_block_t * block_r = (Arena_block_t *)mem;
+	block_r->prev_r = NULL;
+	block_r->cap = cap;
+	return block_r;
+}
+
+void * Alloc_arena(
+	Arena_t * arena_r,
+	size_t size)
 {
-	// Decode_leading_ch Roughly based on Table 3.1B in unicode Corrigendum #1
-	//  Special care is taken to reject 'overlong encodings'
-	//  that is, using more bytes than necessary/allowed for a given code point
+	// NOTE not zeroed, unlike calloc
 
-	/*
-		utf8 can encode up to 21 bits like this
+	size = (size + 15) & ~(size_t)15;
 
-		1-byte = 0 to 7 bits : 		0xxxxxxx
-		2-byte = 8 to 11 bits :		110xxxxx 10xxxxxx
-		3-byte = 12 to 16 bits :	1110xxxx 10xxxxxx 10xxxxxx
-		4-byte = 17 to 21 bits :	11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+	Arena_block_t * block_r = arena_r->block_r;
+	if (!block_r || size > block_r->cap - arena_r->len)
+	{
+		// Grow geometrically, so we only need a few blocks to get as big as any file
 
-		so
-		1-byte if		<= 	0b 0111 1111, 			(0x7f)
-		2-byte if		<= 	0b 0111 1111 1111,		(0x7ff)
-		3-byte if		<= 	0b 1111 1111 1111 1111,	(0xffff)
-		4 byte otherwise
+		size_t cap = (block_r) ? block_r->cap * 2 : arena_block_len_min;
+		while (cap < size)
+		{
+			cap *= 2;
+		}
 
-		The only other details, are that you are not allowed to encode
-		values in [0xD800, 0xDFFF] (the utf16 surogates),
-		or anything > 0x10FFFF (0x10FFFF is the largest valid code point).
+		Arena_block_t * block_new_r = Alloc_arena_block(arena_r, cap);
+		if (!block_new_r)
+		{
+			if (arena_r->oom_r)
+			{
+				longjmp(arena_r->oom_r->jmp, 1);
+			}
 
-		Also note that, 2/3/4 byte values start with a byte with 2/3/4 leading ones.
-		That is how you decode them later. (the trailing bytes all start with '10')
-	*/
+			return NULL;
+		}
 
-	// Check if we have no bytes at all
+		block_new_r->prev_r = block_r;
 
-	size_t span_len = Byte_span_len(span);
-	if (span_len == 0)
-		return Make_ch_len(Mch_end, 0);
+		block_r = block_new_r;
+		arena_r->block_r = block_r;
+		arena_r->len = 0;
+	}
 
-	// Value we return on error
+	Byte_t * mem = (Byte_t *)(block_r + 1) + arena_r->len;
+	arena_r->len += size;
+	return mem;
+}
 
-	Ch_len_t invalid = {Mch_invalid, 1};
+void Reset_arena(Arena_t * arena_r)
+{
+	arena_r->len = 0;
 
-	// Check if first byte is a trailing byte (1 leading 1),
-	//  or if too many leading ones.
+	Arena_block_t * block_r = arena_r->block_r;
+	if (!block_r || !block_r->prev_r)
+		return;
 
-	size_t leading_ones = Leading_ones(*span.begin);
-	if (leading_ones == 1)
-		return invalid;
+	// We needed more than one block since the last reset. Trade them all
+	//  for one block big enough for all of it, so next time one is enough
 
-	if (leading_ones > 4)
-		return invalid;
+	size_t cap = 0;
+	while (block_r)
+	{
+		Arena_block_t * prev_r = block_r->prev_r;
+		cap += block_r->cap;
+		free(block_r);
+		block_r = prev_r;
+	}
 
-	// Compute len from leading_ones
+	arena_r->block_r = Alloc_arena_block(arena_r, cap);
+}
 
-	size_t len;
-	switch (leading_ones)
+void Free_arena(Arena_t * arena_r)
+{
+	Arena_block_t * block_r = arena_r->block_r;
+	while (block_r)
 	{
-	case 0: len = 1; break;
-	case 2: len = 2; break;
-	case 3: len = 3; break;
-	default: len = 4; break;
+		Arena_block_t * prev_r = block_r->prev_r;
+		free(block_r);
+		block_r = prev_r;
 	}
 
-	// Check if we do not have enough bytes
+	arena_r->block_r = NULL;
+	arena_r->len = 0;
+}
 
-	if (len > span_len)
-		return invalid;
 
-	// Check if any trailing bytes are invalid
 
-	for (size_t i = 1; i < len; ++i)
-	{
-		if (Leading_ones(span.begin[i]) != 1)
-			return invalid;
-	}
+// simd : bulk scans, written once per isa, so one build can pick
+//  the best kernels the cpu has at startup (see Kernels_from_isa)
 
-	// Get the significant bits from the first byte
+typedef enum Isa_k // Instruction set
+{
+	Isa_scalar,
+	Isa_sse2,
+	Isa_avx2,
+	Isa_avx512, // avx512f + avx512bw
+} Isa_k;
 
-	char32_t ch = *span.begin;
-	switch (len)
+const char * Str_from_isa(Isa_k isa)
+{
+	switch (isa)
 	{
-	case 2: ch &= 0x1F; break;
-	case 3: ch &= 0x0F; break;
-	case 4: ch &= 0x07; break;
+	case Isa_scalar: return "scalar";
+	case Isa_sse2: return "sse2";
+	case Isa_avx2: return "avx2";
+	case Isa_avx512: return "avx512";
 	}
 
-	// Get bits from the trailing bytes
+	return "?";
+}
 
-	for (size_t i = 1; i < len; ++i)
-	{
-		ch <<= 6;
-		ch |= (span.begin[i] & 0x3F);
-	}
+Isa_k Isa_best()
+{
+	// Best isa this cpu supports. avx2 and avx512 also need the os
+	//  to save their registers on context switches (see xgetbv)
 
-	// Check for illegal codepoints
+	// NOTE msvc lets us use any intrinsic without /arch, and never uses avx2/avx512
+	//  anywhere we did not ask for it, which is what lets one exe pick its kernels here
 
-	if (ch >= 0xD800 && ch <= 0xDFFF)
-		return invalid;
+	int info[4];
+	__cpuid(info, 0);
+	int leaf_max = info[0];
 
-	if (ch > 0x10FFFF)
-		return invalid;
+	__cpuid(info, 1);
+	bool has_sse2 = (info[3] & (1 << 26)) != 0;
+	bool has_osxsave = (info[2] & (1 << 27)) != 0;
 
-	// Check for 'overlong encodings'
+	if (!has_sse2)
+		return Isa_scalar;
 
-	if (ch <= 0x7f && len > 1)
-		return invalid;
+	if (!has_osxsave || leaf_max < 7)
+		return Isa_sse2;
 
-	if (ch <= 0x7ff && len > 2)
-		return invalid;
+	uint64_t xcr0 = _xgetbv(0);
+	bool saves_ymm = (xcr0 & 0x06) == 0x06; // xmm + ymm
+	bool saves_zmm = (xcr0 & 0xE6) == 0xE6; // xmm + ymm + opmask + zmm
 
-	if (ch <= 0xffff && len > 3)
-		return invalid;
+	__cpuidex(info, 7, 0);
+	bool has_avx2 = (info[1] & (1 << 5)) != 0;
+	bool has_avx512f = (info[1] & (1 << 16)) != 0;
+	bool has_avx512bw = (info[1] & (1 << 30)) != 0;
 
-	// We did it, return ch + len
+	if (has_avx512f && has_avx512bw && saves_zmm)
+		return Isa_avx512;
 
-	return Make_ch_len(ch, len);
+	if (has_avx2 && saves_ymm)
+		return Isa_avx2;
+
+	return Isa_sse2;
 }
 
-Ch_loc_t * Decode_byte_span(Byte_span_t span)
-{
-	// Deal with potential UTF-8 BOM
+// Each Isa_*_t says how to load a block of bytes, compare all its lanes at once,
+//  and turn the result into one bit per lane. Chs are squashed down to bytes
+//  with saturation first, so any non-ascii ch (including Mch_end) ends up
+//  with its high bit set.
 
-	size_t span_len = Byte_span_len(span);
+// Lanes_t is whatever the compares give back. For sse2 and avx2 only the
+//  high bit of each lane means anything, so a block is its own Is_non_ascii.
 
-	if (span_len >= 3 &&
-		span.begin[0] == 0xEF &&
-		span.begin[1] == 0xBB &&
-		span.begin[2] == 0xBF)
-	{
-		span.begin += 3;
-		span_len -= 3;
-	}
+// The scans stop at anything non-ascii and let the caller sort it out,
+//  so callers always loop. The scalar kernels stop there too, so every
+//  isa stops in exactly the same places.
 
-	// Allocate space for ch_locs
-	//  In the worst case, we will have a ch_loc for every byte
-	//  in byte_span. Note that we allocate 1 extra ch_loc, so
-	//  we have room for a trailing Mch_end
+struct Isa_sse2_t
+{
+	typedef __m128i Block_t;
+	typedef __m128i Lanes_t;
+	typedef uint32_t Bits_t;
 
-	Ch_loc_t * ary;
-	size_t ary_len = span_len + 1;
+	static const int block_len = 16;
+
+	static Block_t Load_bytes(const Byte_t * it)
 	{
-		size_t size = sizeof(Ch_loc_t);
-		ary = (Ch_loc_t *)calloc(ary_len, size);
+		return _mm_loadu_si128((const __m128i *)it);
 	}
 
-	// Chew through the byte span with Decode_leading_ch,
-	//  until we get to Mch_end.
-
-	size_t i_ch = 0;
-	while (true)
+	static Block_t Load_chs(const char32_t * it)
 	{
-		assert(i_ch < ary_len);
-
-		// Decode
-		
-		Ch_len_t ch_len = Decode_leading_ch(span);
-
-		// Add to ary
-
-		ary[i_ch] = Make_ch_loc(ch_len.ch, span.begin);
+		__m128i chs_0 = _mm_loadu_si128((const __m128i *)(it + 0));
+		__m128i chs_1 = _mm_loadu_si128((const __m128i *)(it + 4));
+		__m128i chs_2 = _mm_loadu_si128((const __m128i *)(it + 8));
+		__m128i chs_3 = _mm_loadu_si128((const __m128i *)(it + 12));
 
-		// Check for Mch_end
+		// Signed saturation takes anything >= 0x8000 to 0x7FFF,
+		//  then unsigned saturation takes anything >= 0x100 to 0xFF
 
-		// NOTE we are letting Mch_invalid through here on purpose,
-		//  so it can be handled by calling code
+		__m128i chs_01 = _mm_packs_epi32(chs_0, chs_1);
+		__m128i chs_23 = _mm_packs_epi32(chs_2, chs_3);
+		return _mm_packus_epi16(chs_01, chs_23);
+	}
 
-		if (ch_len.ch == Mch_end)
-			break;
+	static Lanes_t Eq(Block_t block, char ch)
+	{
+		return _mm_cmpeq_epi8(block, _mm_set1_epi8(ch));
+	}
 
-		// Advance
+	static Lanes_t In_range(Block_t block, char ch_first, char ch_last)
+	{
+		// Signed compares, so non-ascii lanes (negative) are never in range
 
-		++i_ch;
-		span.begin += ch_len.len;
+		return _mm_and_si128(
+					_mm_cmpgt_epi8(block, _mm_set1_epi8((char)(ch_first - 1))),
+					_mm_cmplt_epi8(block, _mm_set1_epi8((char)(ch_last + 1))));
 	}
 
-	// Return the ary
-
-	return ary;
-}
+	static Lanes_t Is_non_ascii(Block_t block)
+	{
+		return block;
+	}
 
+	static Block_t Fold_case(Block_t block)
+	{
+		return _mm_or_si128(block, _mm_set1_epi8(0x20));
+	}
 
+	static Lanes_t Or(Lanes_t lanes_0, Lanes_t lanes_1)
+	{
+		return _mm_or_si128(lanes_0, lanes_1);
+	}
 
-// 'scrub' : replace patterns in ch_loc_ary
+	static Bits_t Bits(Lanes_t lanes)
+	{
+		return (uint32_t)_mm_movemask_epi8(lanes);
+	}
 
-typedef struct Scrub_t
-{
-	Ch_loc_t * it_from;
-	Ch_loc_t * it_to;
-} Scrub_t;
+	static Bits_t Bits_not(Lanes_t lanes)
+	{
+		return ~Bits(lanes) & 0xFFFF;
+	}
+};
 
-Scrub_t Start_scrub(
-	Ch_loc_t * ary)
+struct Isa_avx2_t
 {
-	Scrub_t scrub;
-	scrub.it_from = ary;
-	scrub.it_to = ary;
+	typedef __m256i Block_t;
+	typedef __m256i Lanes_t;
+	typedef uint32_t Bits_t;
 
-	return scrub;
-}
+	static const int block_len = 32;
 
-bool Is_scrub_done(Scrub_t scrub)
-{
-	return scrub.it_from->ch == Mch_end;
-}
+	static Block_t Load_bytes(const Byte_t * it)
+	{
+		return _mm256_loadu_si256((const __m256i *)it);
+	}
 
-char32_t Scrub_peek_ch(Scrub_t scrub, size_t i)
-{
-	return scrub.it_from[i].ch;
-}
+	static Block_t Load_chs(const char32_t * it)
+	{
+		__m256i chs_0 = _mm256_loadu_si256((const __m256i *)(it + 0));
+		__m256i chs_1 = _mm256_loadu_si256((const __m256i *)(it + 8));
+		__m256i chs_2 = _mm256_loadu_si256((const __m256i *)(it + 16));
+		__m256i chs_3 = _mm256_loadu_si256((const __m256i *)(it + 24));
 
-void Advance_scrub(
-	Scrub_t * scrub_r,
-	char32_t ch,
-	size_t len)
-{
-	scrub_r->it_to->ch = ch;
-	scrub_r->it_to->loc = scrub_r->it_from->loc;
+		__m256i chs_01 = _mm256_packs_epi32(chs_0, chs_1);
+		__m256i chs_23 = _mm256_packs_epi32(chs_2, chs_3);
+		__m256i bytes = _mm256_packus_epi16(chs_01, chs_23);
 
-	++scrub_r->it_to;
-	scrub_r->it_from += len;
-}
+		// The packs work within each 128 bit half, so the groups of 4 chs
+		//  come out in the order 0 2 4 6 1 3 5 7. Put them back in order
 
-void End_scrub(Scrub_t scrub)
-{
-	scrub.it_to->ch = Mch_end;
-	scrub.it_to->loc = scrub.it_from->loc;
-}
+		return _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+	}
 
-void Scrub_carriage_returns(
-	Ch_loc_t * ary)
-{
-	Scrub_t scrub = Start_scrub(ary);
-	while (!Is_scrub_done(scrub))
+	static Lanes_t Eq(Block_t block, char ch)
 	{
-		char32_t ch = Scrub_peek_ch(scrub, 0);
-		bool is_cr = ch == '\r';
-		if (is_cr)
-			ch = '\n';
-
-		size_t len = 1;
-		if (is_cr && Scrub_peek_ch(scrub, 1) == '\n')
-		{
-			len = 2;
-		}
-
-		Advance_scrub(&scrub, ch, len);
+		return _mm256_cmpeq_epi8(block, _mm256_set1_epi8(ch));
 	}
-	End_scrub(scrub);
-}
 
-void Scrub_trigraphs(
-	Ch_loc_t * ary)
-{
-	Scrub_t scrub = Start_scrub(ary);
-	while (!Is_scrub_done(scrub))
+	static Lanes_t In_range(Block_t block, char ch_first, char ch_last)
 	{
-		char32_t ch0 = Scrub_peek_ch(scrub, 0);
+		return _mm256_and_si256(
+					_mm256_cmpgt_epi8(block, _mm256_set1_epi8((char)(ch_first - 1))),
+					_mm256_cmpgt_epi8(_mm256_set1_epi8((char)(ch_last + 1)), block));
+	}
 
-		if (ch0 == '?' && Scrub_peek_ch(scrub, 1) == '?')
-		{
-			char32_t ch2 = Scrub_peek_ch(scrub, 2);
+	static Lanes_t Is_non_ascii(Block_t block)
+	{
+		return block;
+	}
 
-			char32_t pairs[][2] =
-			{
-				{ '<', '{' },
-				{ '>', '}' },
-				{ '(', '[' },
-				{ ')', ']' },
-				{ '=', '#' },
-				{ '/', '\\' },
-				{ '\'', '^' },
-				{ '!', '|' },
-				{ '-', '~' },
-			};
-
-			int i_match = -1;
-			for (int i = 0; i < ARY_LEN(pairs); ++i)
-			{
-				if (pairs[i][0] == ch2)
-				{
-					i_match = i;
-					break;
-				}
-			}
+	static Block_t Fold_case(Block_t block)
+	{
+		return _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+	}
 
-			if (i_match != -1)
-			{
-				char32_t ch_replace = pairs[i_match][1];
-				Advance_scrub(&scrub, ch_replace, 3);
+	static Lanes_t Or(Lanes_t lanes_0, Lanes_t lanes_1)
+	{
+		return _mm256_or_si256(lanes_0, lanes_1);
+	}
 
-				continue;
-			}
-		}
+	static Bits_t Bits(Lanes_t lanes)
+	{
+		return (uint32_t)_mm256_movemask_epi8(lanes);
+	}
 
-		Advance_scrub(&scrub, ch0, 1);
+	static Bits_t Bits_not(Lanes_t lanes)
+	{
+		return ~Bits(lanes);
 	}
-	End_scrub(scrub);
-}
+};
 
-void Scrub_leading_escaped_line_breaks(Scrub_t * scrub_r)
+struct Isa_avx512_t
 {
-	// Get length of leading esc eols
-
-	size_t len = 0;
-	while (true)
-	{
-		size_t i = len;
-		if (Scrub_peek_ch(*scrub_r, i) != '\\')
-			break;
+	typedef __m512i Block_t;
+	typedef __mmask64 Lanes_t;
+	typedef uint64_t Bits_t;
 
-		++i;
+	static const int block_len = 64;
 
-		while (Is_hz_ws(Scrub_peek_ch(*scrub_r, i)))
-		{
-			++i;
-		}
+	static Block_t Load_bytes(const Byte_t * it)
+	{
+		return _mm512_loadu_si512(it);
+	}
 
-		// Do not need to check for \r. since that 
-		//  has already been scrubbed.
+	static Block_t Load_chs(const char32_t * it)
+	{
+		// Unsigned saturation takes anything >= 0x100 to 0xFF in one go
 
-		if (Scrub_peek_ch(*scrub_r, i) != '\n')
-			break;
+		__m512i bytes = _mm512_castsi128_si512(_mm512_cvtusepi32_epi8(_mm512_loadu_si512(it + 0)));
+		bytes = _mm512_inserti32x4(bytes, _mm512_cvtusepi32_epi8(_mm512_loadu_si512(it + 16)), 1);
+		bytes = _mm512_inserti32x4(bytes, _mm512_cvtusepi32_epi8(_mm512_loadu_si512(it + 32)), 2);
+		bytes = _mm512_inserti32x4(bytes, _mm512_cvtusepi32_epi8(_mm512_loadu_si512(it + 48)), 3);
+		return bytes;
+	}
 
-		len = i + 1;
+	static Lanes_t Eq(Block_t block, char ch)
+	{
+		return _mm512_cmpeq_epi8_mask(block, _mm512_set1_epi8(ch));
 	}
 
-	// Advance now that we have the length
+	static Lanes_t In_range(Block_t block, char ch_first, char ch_last)
+	{
+		return _mm512_cmpgt_epi8_mask(block, _mm512_set1_epi8((char)(ch_first - 1))) &
+			   _mm512_cmplt_epi8_mask(block, _mm512_set1_epi8((char)(ch_last + 1)));
+	}
 
-	if (len == 0)
+	static Lanes_t Is_non_ascii(Block_t block)
 	{
-		Advance_scrub(scrub_r, Scrub_peek_ch(*scrub_r, 0), 1);
+		return _mm512_movepi8_mask(block);
 	}
-	else if (scrub_r->it_from[len].ch == Mch_end)
+
+	static Block_t Fold_case(Block_t block)
 	{
-		// Drop trailing escaped line break
-		//  (do not include it in a character)
+		return _mm512_or_si512(block, _mm512_set1_epi8(0x20));
+	}
 
-		// BUG this is too clever
-		
-		scrub_r->it_from += len;
+	static Lanes_t Or(Lanes_t lanes_0, Lanes_t lanes_1)
+	{
+		return lanes_0 | lanes_1;
 	}
-	else
+
+	static Bits_t Bits(Lanes_t lanes)
 	{
-		Advance_scrub(
-			scrub_r,
-			Scrub_peek_ch(*scrub_r, len),
-			len + 1);
+		return lanes;
 	}
-}
 
-void Scrub_escaped_line_breaks(
-	Ch_loc_t * ary)
-{
-	Scrub_t scrub = Start_scrub(ary);
-	while (!Is_scrub_done(scrub))
+	static Bits_t Bits_not(Lanes_t lanes)
 	{
-		Scrub_leading_escaped_line_breaks(&scrub);
+		return ~(uint64_t)lanes;
 	}
-	End_scrub(scrub);
+};
+
+template <typename Isa>
+typename Isa::Bits_t Stop_bits_chs(
+	typename Isa::Block_t block,
+	char ch_0,
+	char ch_1,
+	char ch_2)
+{
+	// Lanes that are ch_0/ch_1/ch_2, or not ascii
+
+	typename Isa::Lanes_t is_ch = Isa::Or(
+									Isa::Or(Isa::Eq(block, ch_0), Isa::Eq(block, ch_1)),
+									Isa::Eq(block, ch_2));
+
+	return Isa::Bits(Isa::Or(is_ch, Isa::Is_non_ascii(block)));
 }
 
+template <typename Isa>
+typename Isa::Bits_t Stop_bits_non_ws(typename Isa::Block_t block)
+{
+	// Lanes that are not Is_ws. Is_ws is ' ', or '\t' '\n' '\v' '\f' '\r' (0x09..0x0D)
 
+	return Isa::Bits_not(Isa::Or(Isa::Eq(block, ' '), Isa::In_range(block, 0x09, 0x0D)));
+}
 
-// Lex
+template <typename Isa>
+typename Isa::Lanes_t Is_alnum_lanes(typename Isa::Block_t block)
+{
+	// Lanes that are ascii letters, digits or '_'
 
-// TODO TokkLen_t !!!!!!
+	typename Isa::Lanes_t is_letter = Isa::In_range(Isa::Fold_case(block), 'a', 'z');
+	typename Isa::Lanes_t is_digit = Isa::In_range(block, '0', '9');
 
-#define TOKEN_KINDS()\
-	X(unknown)\
-	X(eof)\
-	X(eod)\
-	X(code_completion)\
-	X(comment)\
-	X(identifier)\
-	X(raw_identifier)\
-	X(numeric_constant)\
-	X(char_constant)\
-	X(wide_char_constant)\
-	X(utf8_char_constant)\
-	X(utf16_char_constant)\
-	X(utf32_char_constant)\
-	X(string_literal)\
-	X(wide_string_literal)\
-	X(header_name)\
-	X(utf8_string_literal)\
-	X(utf16_string_literal)\
-	X(utf32_string_literal)\
-	X(l_square)\
-	X(r_square)\
-	X(l_paren)\
-	X(r_paren)\
-	X(l_brace)\
-	X(r_brace)\
-	X(period)\
-	X(ellipsis)\
-	X(amp)\
-	X(ampamp)\
-	X(ampequal)\
-	X(star)\
-	X(starequal)\
-	X(plus)\
-	X(plusplus)\
-	X(plusequal)\
-	X(minus)\
-	X(arrow)\
-	X(minusminus)\
-	X(minusequal )\
-	X(tilde)\
-	X(exclaim)\
-	X(exclaimequal)\
-	X(slash)\
-	X(slashequal)\
-	X(percent)\
-	X(percentequal)\
-	X(less)\
-	X(lessless)\
-	X(lessequal)\
-	X(lesslessequal)\
-	X(spaceship)\
-	X(greater)\
-	X(greatergreater)\
-	X(greaterequal)\
-	X(greatergreaterequal)\
-	X(caret)\
-	X(caretequal)\
-	X(pipe)\
-	X(pipepipe)\
-	X(pipeequal)\
-	X(question)\
-	X(colon)\
-	X(semi)\
-	X(equal)\
-	X(equalequal)\
-	X(comma)\
-	X(hash)\
-	X(hashhash)\
-	X(hashat)\
-	X(periodstar)\
-	X(arrowstar)\
-	X(coloncolon)\
-	X(at)\
-	X(lesslessless)\
-	X(greatergreatergreater)\
-	X(caretcaret)\
-\
-	X(kw_auto)\
-	X(kw_break)\
-	X(kw_case)\
-	X(kw_char)\
-	X(kw_const)\
-	X(kw_continue)\
-	X(kw_default)\
-	X(kw_do)\
-	X(kw_double)\
-	X(kw_else)\
-	X(kw_enum)\
-	X(kw_extern)\
-	X(kw_float)\
-	X(kw_for)\
-	X(kw_goto)\
-	X(kw_if)\
-	X(kw_int)\
-	X(kw__ExtInt)\
-	X(kw__BitInt)\
-	X(kw_long)\
-	X(kw_register)\
-	X(kw_return)\
-	X(kw_short)\
-	X(kw_signed)\
-	X(kw_sizeof)\
-	X(kw_static)\
-	X(kw_struct)\
-	X(kw_switch)\
-	X(kw_typedef)\
-	X(kw_union)\
-	X(kw_unsigned)\
-	X(kw_void)\
-	X(kw_volatile)\
-	X(kw_while)\
-	X(kw__Alignas)\
-	X(kw__Alignof)\
-	X(kw__Atomic)\
-	X(kw__Bool)\
-	X(kw__Complex)\
-	X(kw__Generic)\
-	X(kw__Imaginary)\
-	X(kw__Noreturn)\
-	X(kw__Static_assert)\
-	X(kw__Thread_local)\
-	X(kw___func__)\
-	X(kw___objc_yes)\
-	X(kw___objc_no)\
-	X(kw_asm)\
-	X(kw_bool)\
-	X(kw_catch)\
-	X(kw_class)\
-	X(kw_const_cast)\
-	X(kw_delete)\
-	X(kw_dynamic_cast)\
-	X(kw_explicit)\
-	X(kw_export)\
-	X(kw_false)\
-	X(kw_friend)\
-	X(kw_mutable)\
-	X(kw_namespace)\
-	X(kw_new)\
-	X(kw_operator)\
-	X(kw_private)\
-	X(kw_protected)\
-	X(kw_public)\
-	X(kw_reinterpret_cast)\
-	X(kw_static_cast)\
-	X(kw_template)\
-	X(kw_this)\
-	X(kw_throw)\
-	X(kw_true)\
-	X(kw_try)\
-	X(kw_typename)\
-	X(kw_typeid)\
-	X(kw_using)\
-	X(kw_virtual)\
-	X(kw_wchar_t)\
-	X(kw_restrict)\
-	X(kw_inline)\
-	X(kw_alignas)\
-	X(kw_alignof)\
-	X(kw_char16_t)\
-	X(kw_char32_t)\
-	X(kw_constexpr)\
-	X(kw_decltype)\
-	X(kw_noexcept)\
-	X(kw_nullptr)\
-	X(kw_static_assert)\
-	X(kw_thread_local)\
-	X(kw_co_await)\
-	X(kw_co_return)\
-	X(kw_co_yield)\
-	X(kw_module)\
-	X(kw_import)\
-	X(kw_consteval)\
-	X(kw_constinit)\
-	X(kw_concept)\
-	X(kw_requires)\
-	X(kw_char8_t)\
-	X(kw__Float16)\
-	X(kw_typeof)\
-	X(kw_typeof_unqual)\
-	X(kw__Accum)\
-	X(kw__Fract)\
-	X(kw__Sat)\
-	X(kw__Decimal32)\
-	X(kw__Decimal64)\
-	X(kw__Decimal128)\
-	X(kw___null)\
-	X(kw___alignof)\
-	X(kw___attribute)\
-	X(kw___builtin_choose_expr)\
-	X(kw___builtin_offsetof)\
-	X(kw___builtin_FILE)\
-	X(kw___builtin_FILE_NAME)\
-	X(kw___builtin_FUNCTION)\
-	X(kw___builtin_FUNCSIG)\
-	X(kw___builtin_LINE)\
-	X(kw___builtin_COLUMN)\
-	X(kw___builtin_source_location)\
-	X(kw___builtin_types_compatible_p)\
-	X(kw___builtin_va_arg)\
-	X(kw___extension__)\
-	X(kw___float128)\
-	X(kw___ibm128)\
-	X(kw___imag)\
-	X(kw___int128)\
-	X(kw___label__)\
-	X(kw___real)\
-	X(kw___thread)\
-	X(kw___FUNCTION__)\
-	X(kw___PRETTY_FUNCTION__)\
-	X(kw___auto_type)\
-	X(kw___FUNCDNAME__)\
-	X(kw___FUNCSIG__)\
-	X(kw_L__FUNCTION__)\
-	X(kw_L__FUNCSIG__)\
-	X(kw___is_interface_class)\
-	X(kw___is_sealed)\
-	X(kw___is_destructible)\
-	X(kw___is_trivially_destructible)\
-	X(kw___is_nothrow_destructible)\
-	X(kw___is_nothrow_assignable)\
-	X(kw___is_constructible)\
-	X(kw___is_nothrow_constructible)\
-	X(kw___is_assignable)\
-	X(kw___has_nothrow_move_assign)\
-	X(kw___has_trivial_move_assign)\
-	X(kw___has_trivial_move_constructor)\
-	X(kw___has_nothrow_assign)\
-	X(kw___has_nothrow_copy)\
-	X(kw___has_nothrow_constructor)\
-	X(kw___has_trivial_assign)\
-	X(kw___has_trivial_copy)\
-	X(kw___has_trivial_constructor)\
-	X(kw___has_trivial_destructor)\
-	X(kw___has_virtual_destructor)\
-	X(kw___is_abstract)\
-	X(kw___is_aggregate)\
-	X(kw___is_base_of)\
-	X(kw___is_class)\
-	X(kw___is_convertible_to)\
-	X(kw___is_empty)\
-	X(kw___is_enum)\
-	X(kw___is_final)\
-	X(kw___is_literal)\
-	X(kw___is_pod)\
-	X(kw___is_polymorphic)\
-	X(kw___is_standard_layout)\
-	X(kw___is_trivial)\
-	X(kw___is_trivially_assignable)\
-	X(kw___is_trivially_constructible)\
-	X(kw___is_trivially_copyable)\
-	X(kw___is_union)\
-	X(kw___has_unique_object_representations)\
-	X(kw___add_lvalue_reference)\
-	X(kw___add_pointer)\
-	X(kw___add_rvalue_reference)\
-	X(kw___decay)\
-	X(kw___make_signed)\
-	X(kw___make_unsigned)\
-	X(kw___remove_all_extents)\
-	X(kw___remove_const)\
-	X(kw___remove_cv)\
-	X(kw___remove_cvref)\
-	X(kw___remove_extent)\
-	X(kw___remove_pointer)\
-	X(kw___remove_reference_t)\
-	X(kw___remove_restrict)\
-	X(kw___remove_volatile)\
-	X(kw___underlying_type)\
-	X(kw___is_trivially_relocatable)\
-	X(kw___is_trivially_equality_comparable)\
-	X(kw___is_bounded_array)\
-	X(kw___is_unbounded_array)\
-	X(kw___is_nullptr)\
-	X(kw___is_scoped_enum)\
-	X(kw___is_referenceable)\
-	X(kw___can_pass_in_regs)\
-	X(kw___reference_binds_to_temporary)\
-	X(kw___is_lvalue_expr)\
-	X(kw___is_rvalue_expr)\
-	X(kw___is_arithmetic)\
-	X(kw___is_floating_point)\
-	X(kw___is_integral)\
-	X(kw___is_complete_type)\
-	X(kw___is_void)\
-	X(kw___is_array)\
-	X(kw___is_function)\
-	X(kw___is_reference)\
-	X(kw___is_lvalue_reference)\
-	X(kw___is_rvalue_reference)\
-	X(kw___is_fundamental)\
-	X(kw___is_object)\
-	X(kw___is_scalar)\
-	X(kw___is_compound)\
-	X(kw___is_pointer)\
-	X(kw___is_member_object_pointer)\
-	X(kw___is_member_function_pointer)\
-	X(kw___is_member_pointer)\
-	X(kw___is_const)\
-	X(kw___is_volatile)\
-	X(kw___is_signed)\
-	X(kw___is_unsigned)\
-	X(kw___is_same)\
-	X(kw___is_convertible)\
-	X(kw___array_rank)\
-	X(kw___array_extent)\
-	X(kw___private_extern__)\
-	X(kw___module_private__)\
-	X(kw___declspec)\
-	X(kw___cdecl)\
-	X(kw___stdcall)\
-	X(kw___fastcall)\
-	X(kw___thiscall)\
-	X(kw___regcall)\
-	X(kw___vectorcall)\
-	X(kw___forceinline)\
-	X(kw___unaligned)\
-	X(kw___super)\
-	X(kw___global)\
-	X(kw___local)\
-	X(kw___constant)\
-	X(kw___private)\
-	X(kw___generic)\
-	X(kw___kernel)\
-	X(kw___read_only)\
-	X(kw___write_only)\
-	X(kw___read_write)\
-	X(kw___builtin_astype)\
-	X(kw_vec_step)\
-	X(kw_image1d_t)\
-	X(kw_image1d_array_t)\
-	X(kw_image1d_buffer_t)\
-	X(kw_image2d_t)\
-	X(kw_image2d_array_t)\
-	X(kw_image2d_depth_t)\
-	X(kw_image2d_array_depth_t)\
-	X(kw_image2d_msaa_t)\
-	X(kw_image2d_array_msaa_t)\
-	X(kw_image2d_msaa_depth_t)\
-	X(kw_image2d_array_msaa_depth_t)\
-	X(kw_image3d_t)\
-	X(kw_pipe)\
-	X(kw_addrspace_cast)\
-	X(kw___noinline__)\
-	X(kw_cbuffer)\
-	X(kw_tbuffer)\
-	X(kw_groupshared)\
-	X(kw___builtin_omp_required_simd_align)\
-	X(kw___pascal)\
-	X(kw___vector)\
-	X(kw___pixel)\
-	X(kw___bool)\
-	X(kw___bf16)\
-	X(kw_half)\
-	X(kw___bridge)\
-	X(kw___bridge_transfer)\
-	X(kw___bridge_retained)\
-	X(kw___bridge_retain)\
-	X(kw___covariant)\
-	X(kw___contravariant)\
-	X(kw___kindof)\
-	X(kw__Nonnull)\
-	X(kw__Nullable)\
-	X(kw__Nullable_result)\
-	X(kw__Null_unspecified)\
-	X(kw___funcref)\
-	X(kw___ptr64)\
-	X(kw___ptr32)\
-	X(kw___sptr)\
-	X(kw___uptr)\
-	X(kw___w64)\
-	X(kw___uuidof)\
-	X(kw___try)\
-	X(kw___finally)\
-	X(kw___leave)\
-	X(kw___int64)\
-	X(kw___if_exists)\
-	X(kw___if_not_exists)\
-	X(kw___single_inheritance)\
-	X(kw___multiple_inheritance)\
-	X(kw___virtual_inheritance)\
-	X(kw___interface)\
-	X(kw___builtin_convertvector)\
-	X(kw___builtin_bit_cast)\
-	X(kw___builtin_available)\
-	X(kw___builtin_sycl_unique_stable_name)\
-	X(kw___arm_streaming)\
-	X(kw___unknown_anytype)\
-\
-	X(annot_cxxscope)\
-	X(annot_typename)\
-	X(annot_template_id)\
-	X(annot_non_type)\
-	X(annot_non_type_undeclared)\
-	X(annot_non_type_dependent)\
-	X(annot_overload_set)\
-	X(annot_primary_expr)\
-	X(annot_decltype)\
-	X(annot_pragma_unused)\
-	X(annot_pragma_vis)\
-	X(annot_pragma_pack)\
-	X(annot_pragma_parser_crash)\
-	X(annot_pragma_captured)\
-	X(annot_pragma_dump)\
-	X(annot_pragma_msstruct)\
-	X(annot_pragma_align)\
-	X(annot_pragma_weak)\
-	X(annot_pragma_weakalias)\
-	X(annot_pragma_redefine_extname)\
-	X(annot_pragma_fp_contract)\
-	X(annot_pragma_fenv_access)\
-	X(annot_pragma_fenv_access_ms)\
-	X(annot_pragma_fenv_round)\
-	X(annot_pragma_float_control)\
-	X(annot_pragma_ms_pointers_to_members)\
-	X(annot_pragma_ms_vtordisp)\
-	X(annot_pragma_ms_pragma)\
-	X(annot_pragma_opencl_extension)\
-	X(annot_attr_openmp)\
-	X(annot_pragma_openmp)\
-	X(annot_pragma_openmp_end)\
-	X(annot_pragma_loop_hint)\
-	X(annot_pragma_fp)\
-	X(annot_pragma_attribute)\
-	X(annot_pragma_riscv)\
-	X(annot_module_include)\
-	X(annot_module_begin)\
-	X(annot_module_end)\
-	X(annot_header_unit)\
-	X(annot_repl_input_end)
-
-typedef enum Tokk_t
-{
-	#define X(id) Tokk_##id,
-	TOKEN_KINDS()
-	#undef X
-} Tokk_t;
+	return Isa::Or(Isa::Or(is_letter, is_digit), Isa::Eq(block, '_'));
+}
 
-const char * Str_from_tokk(Tokk_t tokk)
+template <typename Isa>
+typename Isa::Bits_t Stop_bits_non_id(typename Isa::Block_t block)
 {
-	static const char *  str_for_tokk[] =
-	{
-		#define X(id) #id,
-		TOKEN_KINDS()	
-		#undef X
-	};
+	// Lanes that are not ascii chs that extend ids (letters, digits, '_', '$')
 
-	return str_for_tokk[tokk];
+	return Isa::Bits_not(Isa::Or(Is_alnum_lanes<Isa>(block), Isa::Eq(block, '$')));
 }
 
-typedef struct Tokk_end_t
+template <typename Isa>
+typename Isa::Bits_t Stop_bits_non_ppnum(typename Isa::Block_t block)
 {
-	Tokk_t tokk;
-	Ch_loc_t * end;
-} Tokk_end_t;
+	// Lanes that are not ascii chs that extend ppnums (letters, digits, '_', '.').
+	//  No '$', since clang does not allow it in ppnums. Signs after an exponent
+	//  are stop lanes too, the ppnum kernels deal with those.
+
+	return Isa::Bits_not(Isa::Or(Is_alnum_lanes<Isa>(block), Isa::Eq(block, '.')));
+}
 
-Tokk_end_t Make_tokk_end(Tokk_t tokk, Ch_loc_t * end)
+bool Is_ascii_alnum(char32_t ch)
 {
-	Tokk_end_t result = {tokk, end};
-	return result;
+	return (ch >= 'a' && ch <= 'z') ||
+		   (ch >= 'A' && ch <= 'Z') ||
+		   (ch >= '0' && ch <= '9') ||
+		   ch == '_';
 }
 
-Tokk_end_t Lex_punctuation(
-	Ch_loc_t * it)
+bool Is_exponent_sign(
+	char32_t ch_prev,
+	char32_t ch)
 {
-	// Punctuation sorted by length
+	// [eEpP][+-] extends a ppnum
 
-	// "::" is included to match clang
-	// https://github.com/llvm/llvm-project/commit/874217f99b99ab3c9026dc3b7bd84cd2beebde6e
+	return (ch == '+' || ch == '-') &&
+		   (ch_prev == 'e' || ch_prev == 'E' || ch_prev == 'p' || ch_prev == 'P');
+}
 
-	typedef struct
-	{
-		const char32_t * str;
-		Tokk_t tokk;
-	} Str_tokk_t;
-
-	static Str_tokk_t puncts[] =
-	{
-		{U"%:%:", Tokk_hashhash},
-		{U">>=", Tokk_greatergreaterequal},
-		{U"<<=", Tokk_lesslessequal},
-		{U"...", Tokk_ellipsis},
-		{U"|=", Tokk_pipeequal},
-		{U"||", Tokk_pipepipe},
-		{U"^=", Tokk_caretequal},
-		{U"==", Tokk_equalequal},
-		{U"::", Tokk_coloncolon},
-		{U":>", Tokk_r_square},
-		{U"-=", Tokk_minusequal},
-		{U"--", Tokk_minusminus},
-		{U"->", Tokk_arrow},
-		{U"+=", Tokk_plusequal},
-		{U"++", Tokk_plusplus},
-		{U"*=", Tokk_starequal},
-		{U"&=", Tokk_ampequal},
-		{U"&&", Tokk_ampamp},
-		{U"##", Tokk_hashhash},
-		{U"!=", Tokk_exclaimequal},
-		{U">=", Tokk_greaterequal},
-		{U">>", Tokk_greatergreater},
-		{U"<=", Tokk_lessequal},
-		{U"<:", Tokk_l_square},
-		{U"<%", Tokk_l_brace},
-		{U"<<", Tokk_lessless},
-		{U"%>", Tokk_r_brace},
-		{U"%=", Tokk_percentequal},
-		{U"%:", Tokk_hash},
-		{U"/=", Tokk_slashequal},
-		{U"~", Tokk_tilde},
-		{U"}", Tokk_r_brace},
-		{U"{", Tokk_l_brace},
-		{U"]", Tokk_r_square},
-		{U"[", Tokk_l_square},
-		{U"?", Tokk_question},
-		{U";", Tokk_semi},
-		{U",", Tokk_comma},
-		{U")", Tokk_r_paren},
-		{U"(", Tokk_l_paren},
-		{U"|", Tokk_pipe},
-		{U"^", Tokk_caret},
-		{U"=", Tokk_equal},
-		{U":", Tokk_colon},
-		{U"-", Tokk_minus},
-		{U"+", Tokk_plus},
-		{U"*", Tokk_star},
-		{U"&", Tokk_amp},
-		{U"#", Tokk_hash},
-		{U"!", Tokk_exclaim},
-		{U">", Tokk_greater},
-		{U"<", Tokk_less},
-		{U"%", Tokk_percent},
-		{U".", Tokk_period},
-		{U"/", Tokk_slash},
-	};
+// The kernels. *_in_chs scan a Ch_loc_ary_t, and read up to a block past
+//  Mch_end (see ch_ary_pad). *_in_bytes scan ascii bytes up to end.
 
-	for (int i_punct = 0; i_punct < ARY_LEN(puncts); ++i_punct)
-	{
-		Str_tokk_t punct = puncts[i_punct];
-		const char32_t * str = punct.str;
-
-		// Empty str in puncts? skip it
+// Len_leading_ascii : count leading bytes that do not have the high bit set
 
-		if (str[0] == '\0')
-			continue;
+size_t Len_leading_ascii_scalar(Byte_span_t span)
+{
+	size_t span_len = Byte_span_len(span);
+	size_t len = 0;
 
-		// Check if ary starts with str
+	while (len < span_len && span.begin[len] < 0x80)
+	{
+		++len;
+	}
 
-		bool found_match = false;
+	return len;
+}
 
-		Ch_loc_t * it_check = it;
-		while (true)
-		{
-			if (it_check->ch != str[0])
-				break;
+template <typename Isa>
+size_t Len_leading_ascii_simd(Byte_span_t span)
+{
+	size_t span_len = Byte_span_len(span);
+	size_t len = 0;
 
-			++it_check;
-			++str;
+	while (span_len - len >= (size_t)Isa::block_len)
+	{
+		typename Isa::Bits_t high_bits = Isa::Bits(Isa::Is_non_ascii(Isa::Load_bytes(span.begin + len)));
+		if (high_bits)
+			return len + Count_trailing_zeros(high_bits);
 
-			if (str[0] == '\0')
-			{
-				// Reached end of str, so we have a match
+		len += Isa::block_len;
+	}
 
-				found_match = true;
-				break;
-			}
-		}
+	Byte_span_t span_tail = {span.begin + len, span.end};
+	return len + Len_leading_ascii_scalar(span_tail);
+}
 
-		// Found a match, return tokk + end
+// Scan_toward_chs : move toward the next ch_0/ch_1/ch_2
 
-		if (found_match)
-			return Make_tokk_end(punct.tokk, it_check);
+char32_t * Scan_toward_chs_in_chs_scalar(
+	char32_t * it,
+	char ch_0,
+	char ch_1,
+	char ch_2)
+{
+	while (*it < 0x80 && *it != (char32_t)ch_0 && *it != (char32_t)ch_1 && *it != (char32_t)ch_2)
+	{
+		++it;
 	}
 
-	// Just return leading char as an unknown token
-
-	return Make_tokk_end(Tokk_unknown, it + 1);
+	return it;
 }
 
-bool Extends_id(char32_t ch)
+Byte_t * Scan_toward_chs_in_bytes_scalar(
+	Byte_t * it,
+	Byte_t * end,
+	char ch_0,
+	char ch_1,
+	char ch_2)
 {
-	// Letters
-
-	if (ch >= 'a' && ch <= 'z')
-		return true;
-
-	if (ch >= 'A' && ch <= 'Z')
-		return true;
-
-	// Underscore
-
-	if (ch == '_')
-		return true;
-
-	// Digits
-
-	if (ch >= '0' && ch <= '9')
-		return true;
+	while (it < end && *it < 0x80 && *it != ch_0 && *it != ch_1 && *it != ch_2)
+	{
+		++it;
+	}
 
-	// '$' allowed as an extension :/
+	return it;
+}
 
-	if (ch == '$')
-		return true;
+template <typename Isa>
+char32_t * Scan_toward_chs_in_chs_simd(
+	char32_t * it,
+	char ch_0,
+	char ch_1,
+	char ch_2)
+{
+	while (true)
+	{
+		typename Isa::Bits_t stop_bits = Stop_bits_chs<Isa>(Isa::Load_chs(it), ch_0, ch_1, ch_2);
+		if (stop_bits)
+			return it + Count_trailing_zeros(stop_bits);
 
-	// All other ascii is invalid
-	
-	if (ch <= 0x7F) 
-		return false;
+		it += Isa::block_len;
+	}
+}
 
-	// Bogus utf8 does not extend ids
+template <typename Isa>
+Byte_t * Scan_toward_chs_in_bytes_simd(
+	Byte_t * it,
+	Byte_t * end,
+	char ch_0,
+	char ch_1,
+	char ch_2)
+{
+	while (end - it >= Isa::block_len)
+	{
+		typename Isa::Bits_t stop_bits = Stop_bits_chs<Isa>(Isa::Load_bytes(it), ch_0, ch_1, ch_2);
+		if (stop_bits)
+			return it + Count_trailing_zeros(stop_bits);
 
-	if (ch > 0x10ffff)
-		return false;
+		it += Isa::block_len;
+	}
 
-	// These code points are allowed to extend an id
+	return Scan_toward_chs_in_bytes_scalar(it, end, ch_0, ch_1, ch_2);
+}
 
-	// BUG should document where the heck these came from clearly.
-	//  tldr I stared at the clang source code to figure these out,
-	//  (but it would be nice to site the offcial standard here)
+// Scan_toward_triggers : move toward the next ch_0/ch_1/ch_2 in raw bytes. Unlike
+//  Scan_toward_chs, this does not stop at non-ascii bytes, it is for finding
+//  what the scrub passes care about ('\r', '?', '\\'), which are all ascii
 
-	static const char32_t yes[][2] =
+Byte_t * Scan_toward_triggers_in_bytes_scalar(
+	Byte_t * it,
+	Byte_t * end,
+	char ch_0,
+	char ch_1,
+	char ch_2)
+{
+	while (it < end && *it != ch_0 && *it != ch_1 && *it != ch_2)
 	{
-		{ 0x00A8, 0x00A8 }, { 0x00AA, 0x00AA }, { 0x00AD, 0x00AD },
-		{ 0x00AF, 0x00AF }, { 0x00B2, 0x00B5 }, { 0x00B7, 0x00BA },
-		{ 0x00BC, 0x00BE }, { 0x00C0, 0x00D6 }, { 0x00D8, 0x00F6 },
-		{ 0x00F8, 0x00FF },
-
-		{ 0x0100, 0x167F }, { 0x1681, 0x180D }, { 0x180F, 0x1FFF },
-
-		{ 0x200B, 0x200D }, { 0x202A, 0x202E }, { 0x203F, 0x2040 },
-		{ 0x2054, 0x2054 }, { 0x2060, 0x206F },
-
-		{ 0x2070, 0x218F }, { 0x2460, 0x24FF }, { 0x2776, 0x2793 },
-		{ 0x2C00, 0x2DFF }, { 0x2E80, 0x2FFF },
+		++it;
+	}
 
-		{ 0x3004, 0x3007 }, { 0x3021, 0x302F }, { 0x3031, 0x303F },
+	return it;
+}
 
-		{ 0x3040, 0xD7FF },
+template <typename Isa>
+Byte_t * Scan_toward_triggers_in_bytes_simd(
+	Byte_t * it,
+	Byte_t * end,
+	char ch_0,
+	char ch_1,
+	char ch_2)
+{
+	while (end - it >= Isa::block_len)
+	{
+		typename Isa::Block_t block = Isa::Load_bytes(it);
+		typename Isa::Bits_t stop_bits = Isa::Bits(
+											Isa::Or(
+												Isa::Or(Isa::Eq(block, ch_0), Isa::Eq(block, ch_1)),
+												Isa::Eq(block, ch_2)));
+		if (stop_bits)
+			return it + Count_trailing_zeros(stop_bits);
+
+		it += Isa::block_len;
+	}
 
-		{ 0xF900, 0xFD3D }, { 0xFD40, 0xFDCF }, { 0xFDF0, 0xFE44 },
-		{ 0xFE47, 0xFFFD },
+	return Scan_toward_triggers_in_bytes_scalar(it, end, ch_0, ch_1, ch_2);
+}
 
-		{ 0x10000, 0x1FFFD }, { 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD },
-		{ 0x40000, 0x4FFFD }, { 0x50000, 0x5FFFD }, { 0x60000, 0x6FFFD },
-		{ 0x70000, 0x7FFFD }, { 0x80000, 0x8FFFD }, { 0x90000, 0x9FFFD },
-		{ 0xA0000, 0xAFFFD }, { 0xB0000, 0xBFFFD }, { 0xC0000, 0xCFFFD },
-		{ 0xD0000, 0xDFFFD }, { 0xE0000, 0xEFFFD }
-	};
+// Scan_past_ws : move past any whitespace
 
-	for (int i = 0; i < ARY_LEN(yes); ++i)
+char32_t * Scan_past_ws_in_chs_scalar(char32_t * it)
+{
+	while (Is_ws(*it))
 	{
-		char32_t first = yes[i][0];
-		char32_t last = yes[i][1];
-		if (ch >= first && ch <= last)
-			return true;
+		++it;
 	}
 
-	return false;
+	return it;
 }
 
-bool Starts_id(char32_t ch)
+Byte_t * Scan_past_ws_in_bytes_scalar(
+	Byte_t * it,
+	Byte_t * end)
 {
-	// Does not extend ids? then does not start them either
-
-	if (!Extends_id(ch))
-		return false;
+	while (it < end && Is_ws(*it))
+	{
+		++it;
+	}
 
-	// Digits don't start ids
+	return it;
+}
 
-	if (ch >= '0' && ch <= '9') 
-		return false;
+template <typename Isa>
+char32_t * Scan_past_ws_in_chs_simd(char32_t * it)
+{
+	while (true)
+	{
+		typename Isa::Bits_t stop_bits = Stop_bits_non_ws<Isa>(Isa::Load_chs(it));
+		if (stop_bits)
+			return it + Count_trailing_zeros(stop_bits);
 
-	// Any ascii that gets past Extends_id starts ids
+		it += Isa::block_len;
+	}
+}
 
-	if (ch <= 0x7F) 
-		return true;
+template <typename Isa>
+Byte_t * Scan_past_ws_in_bytes_simd(
+	Byte_t * it,
+	Byte_t * end)
+{
+	while (end - it >= Isa::block_len)
+	{
+		typename Isa::Bits_t stop_bits = Stop_bits_non_ws<Isa>(Isa::Load_bytes(it));
+		if (stop_bits)
+			return it + Count_trailing_zeros(stop_bits);
 
-	// These codepoints are not allowed as the start of an id
+		it += Isa::block_len;
+	}
 
-	// BUG same comment as the 'yes' ary in Extends_id
+	return Scan_past_ws_in_bytes_scalar(it, end);
+}
 
-	static const char32_t no[][2] =
-	{
-		{ 0x0300, 0x036F },
-		{ 0x1DC0, 0x1DFF },
-		{ 0x20D0, 0x20FF },
-		{ 0xFE20, 0xFE2F }
-	};
+// Scan_past_id_run : move past any ascii chs that extend ids
 
-	for (int i = 0; i < ARY_LEN(no); ++i)
+char32_t * Scan_past_id_run_in_chs_scalar(char32_t * it)
+{
+	while (*it < 0x80 && (Is_ascii_alnum(*it) || *it == '$'))
 	{
-		char32_t first = no[i][0];
-		char32_t last = no[i][1];
-		if (ch >= first && ch <= last)
-			return false;
+		++it;
 	}
 
-	return true;
+	return it;
 }
 
-bool Is_valid_ucn(char32_t ch)
+Byte_t * Scan_past_id_run_in_bytes_scalar(
+	Byte_t * it,
+	Byte_t * end)
 {
-	// A universal character name shall not specify a character whose
-	//  short identifier is less than 00A0, nor one in the range 
-	//  D800 through DFFF inclusive.
-
-	// BUG cite location in standard this working appears
+	while (it < end && (Is_ascii_alnum(*it) || *it == '$'))
+	{
+		++it;
+	}
 
-	if (ch < 0xA0)
-		return false;
+	return it;
+}
 
-	if (ch >= 0xD800 && ch <= 0xDFFF)
-		return false;
+template <typename Isa>
+char32_t * Scan_past_id_run_in_chs_simd(char32_t * it)
+{
+	while (true)
+	{
+		typename Isa::Bits_t stop_bits = Stop_bits_non_id<Isa>(Isa::Load_chs(it));
+		if (stop_bits)
+			return it + Count_trailing_zeros(stop_bits);
 
-	return true;
+		it += Isa::block_len;
+	}
 }
 
-uint32_t Hex_val_from_ch(char32_t ch)
+template <typename Isa>
+Byte_t * Scan_past_id_run_in_bytes_simd(
+	Byte_t * it,
+	Byte_t * end)
 {
-	if (ch >= '0' && ch <= '9')
-		return ch - '0';
-
-	if (ch >= 'A' && ch <= 'F')
-		return ch - 'A' + 10;
+	while (end - it >= Isa::block_len)
+	{
+		typename Isa::Bits_t stop_bits = Stop_bits_non_id<Isa>(Isa::Load_bytes(it));
+		if (stop_bits)
+			return it + Count_trailing_zeros(stop_bits);
 
-	if (ch >= 'a' && ch <= 'f')
-		return ch - 'a' + 10;
+		it += Isa::block_len;
+	}
 
-	return Mch_invalid;
+	return Scan_past_id_run_in_bytes_scalar(it, end);
 }
 
-typedef struct Ch_end_t
-{
-	char32_t ch;
-	Ch_loc_t * end;
-} Ch_end_t;
+// Scan_past_ppnum_run : move past any ascii chs that extend ppnums, including [eEpP][+-].
 
-Ch_end_t Make_ch_end(char32_t ch, Ch_loc_t * end)
-{
-	Ch_end_t result = {ch, end};
-	return result;
-}
+// NOTE the ch before it is never an exponent, since callers only 
+//  start us after a digit, '.', ucn or non-ascii ch
 
-Ch_end_t Lex_ucn(
-	Ch_loc_t * it)
+char32_t * Scan_past_ppnum_run_in_chs_scalar(char32_t * it)
 {
-	Ch_end_t invalid = {Mch_invalid, NULL};
-
-	// Leading '\\'
+	while (true)
+	{
+		char32_t ch = *it;
+		if (ch == '.' || (ch < 0x80 && Is_ascii_alnum(ch)))
+		{
+			++it;
 
-	if (it->ch != '\\')
-		return invalid;
+			if (Is_exponent_sign(ch, *it))
+			{
+				++it;
+			}
 
-	++it;
+			continue;
+		}
 
-	// U\u
+		break;
+	}
 
-	if (it->ch != 'u' && it->ch != 'U')
-		return invalid;
+	return it;
+}
 
-	int digits_need;
-	if (it->ch == 'u')
-	{
-		digits_need = 4;
-	}
-	else
+Byte_t * Scan_past_ppnum_run_in_bytes_scalar(
+	Byte_t * it,
+	Byte_t * end)
+{
+	while (it < end && (*it == '.' || Is_ascii_alnum(*it)))
 	{
-		digits_need = 8;
-	}
+		Byte_t byte = *it;
+		++it;
 
-	++it;
+		if (it < end && Is_exponent_sign(byte, *it))
+		{
+			++it;
+		}
+	}
 
-	// String of hex digits, possibly between {}
+	return it;
+}
 
-	char32_t result = 0;
-	int digits_read = 0;
-	bool delimited = false;
-	bool got_end_delim = false;
+template <typename Isa>
+char32_t * Scan_past_ppnum_run_in_chs_simd(char32_t * it)
+{
+	char32_t * it_begin = it;
 
-	while (digits_read < digits_need || delimited)
+	while (true)
 	{
-		// Handle {}
-
-		if (!delimited && digits_read == 0 && it->ch == '{')
+		typename Isa::Bits_t stop_bits = Stop_bits_non_ppnum<Isa>(Isa::Load_chs(it));
+		if (!stop_bits)
 		{
-			delimited = true;
-			++it;
-			
+			it += Isa::block_len;
 			continue;
 		}
 
-		if (delimited && it->ch == '}')
+		it += Count_trailing_zeros(stop_bits);
+
+		if (it != it_begin && Is_exponent_sign(it[-1], *it))
 		{
-			got_end_delim = true;
 			++it;
-			
-			break;
+			continue;
 		}
 
-		// Check if valid hex digit
+		return it;
+	}
+}
 
-		char32_t val = Hex_val_from_ch(it->ch);
-		if (val == Mch_invalid)
-		{
-			if (delimited)
-				return invalid;
+template <typename Isa>
+Byte_t * Scan_past_ppnum_run_in_bytes_simd(
+	Byte_t * it,
+	Byte_t * end)
+{
+	Byte_t * it_begin = it;
 
-			break;
+	while (end - it >= Isa::block_len)
+	{
+		typename Isa::Bits_t stop_bits = Stop_bits_non_ppnum<Isa>(Isa::Load_bytes(it));
+		if (!stop_bits)
+		{
+			it += Isa::block_len;
+			continue;
 		}
 
-		// Avoid overflow
-
-		if (result & 0xF000'0000)
-			return invalid;
+		it += Count_trailing_zeros(stop_bits);
 
-		// Single hex digit
+		if (it != it_begin && Is_exponent_sign(it[-1], *it))
+		{
+			++it;
+			continue;
+		}
 
-		result <<= 4;
-		result |= val;
+		return it;
+	}
 
-		++digits_read;
+	// The last block may have ended right on an exponent
 
+	if (it != it_begin && it < end && Is_exponent_sign(it[-1], *it))
+	{
 		++it;
 	}
 
-	// Error checks
-
-	if (digits_read == 0)
-		return invalid;
+	return Scan_past_ppnum_run_in_bytes_scalar(it, end);
+}
 
-	if (!delimited && digits_read != digits_need)
-		return invalid;
+// Scan_line_starts : push the off just past each line break ('\n', "\r\n", or a lone '\r'),
+//  until we run out of bytes or of room in offs. Offs are relative to begin
 
-	// Note that we still return a valid end ptr if !Is_valid_ucn.
-	//  This lets us tell the difference between a syntactically invalid
-	//  ucn, and a 'semanticaly' invalid one.
+Byte_t * Scan_line_starts_in_bytes_scalar(
+	Byte_t * it,
+	Byte_t * end,
+	Byte_t * begin,
+	uint32_t ** offs_r,
+	uint32_t * offs_end)
+{
+	uint32_t * offs = *offs_r;
 
-	if (!Is_valid_ucn(result))
+	while (it < end && offs < offs_end)
 	{
-		result = Mch_invalid;
+		Byte_t byte = *it;
+		++it;
+
+		if (byte == '\n' || (byte == '\r' && (it == end || *it != '\n')))
+		{
+			*offs = (uint32_t)(it - begin);
+			++offs;
+		}
 	}
 
-	return Make_ch_end(result, it);
+	*offs_r = offs;
+	return it;
 }
 
-Ch_loc_t * After_rest_of_id(Ch_loc_t * it)
+template <typename Isa>
+Byte_t * Scan_line_starts_in_bytes_simd(
+	Byte_t * it,
+	Byte_t * end,
+	Byte_t * begin,
+	uint32_t ** offs_r,
+	uint32_t * offs_end)
 {
-	while (true)
+	// Only loop while a whole block of breaks would still fit in offs
+
+	uint32_t * offs = *offs_r;
+
+	while (end - it >= Isa::block_len && offs_end - offs >= Isa::block_len)
 	{
-		if (Extends_id(it->ch))
-		{
-			++it;
-			continue;
-		}
+		typename Isa::Block_t block = Isa::Load_bytes(it);
+		typename Isa::Bits_t lf_bits = Isa::Bits(Isa::Eq(block, '\n'));
+		typename Isa::Bits_t cr_bits = Isa::Bits(Isa::Eq(block, '\r'));
 
-		if (it->ch == '\\')
+		if (cr_bits)
 		{
-			// Yes, the standard says you can have ucn's in identifers :/ ...
+			// A '\r' right before a '\n' is half of a "\r\n", the '\n' ends that line
 
-			Ch_end_t ucn = Lex_ucn(it);
-			if (ucn.end && Extends_id(ucn.ch))
+			typename Isa::Bits_t before_lf_bits = lf_bits >> 1;
+			if (end - it > Isa::block_len && it[Isa::block_len] == '\n')
 			{
-				it = ucn.end;
-				continue;
+				before_lf_bits |= (typename Isa::Bits_t)1 << (Isa::block_len - 1);
 			}
+
+			cr_bits &= ~before_lf_bits;
 		}
 
-		break;
+		typename Isa::Bits_t break_bits = lf_bits | cr_bits;
+		uint32_t off = (uint32_t)(it - begin) + 1;
+
+		while (break_bits)
+		{
+			*offs = off + Count_trailing_zeros(break_bits);
+			++offs;
+
+			break_bits &= break_bits - 1;
+		}
+
+		it += Isa::block_len;
 	}
 
-	return it;
+	*offs_r = offs;
+	return Scan_line_starts_in_bytes_scalar(it, end, begin, offs_r, offs_end);
 }
 
-Ch_loc_t * After_rest_of_ppnum(Ch_loc_t * it)
+typedef struct Kernels_t
 {
-	/* NOTE (matthewd)
-		preprocesor numbers are a bit unintuitive,
-		since they can match things that are not valid tokens
-		in later translation phases.
+	Isa_k isa;
+
+	size_t (* Len_leading_ascii)(Byte_span_t span);
+
+	char32_t * (* Scan_toward_chs_in_chs)(char32_t * it, char ch_0, char ch_1, char ch_2);
+	Byte_t * (* Scan_toward_chs_in_bytes)(Byte_t * it, Byte_t * end, char ch_0, char ch_1, char ch_2);
+	Byte_t * (* Scan_toward_triggers_in_bytes)(Byte_t * it, Byte_t * end, char ch_0, char ch_1, char ch_2);
+
+	char32_t * (* Scan_past_ws_in_chs)(char32_t * it);
+	Byte_t * (* Scan_past_ws_in_bytes)(Byte_t * it, Byte_t * end);
+
+	char32_t * (* Scan_past_id_run_in_chs)(char32_t * it);
+	Byte_t * (* Scan_past_id_run_in_bytes)(Byte_t * it, Byte_t * end);
+
+	char32_t * (* Scan_past_ppnum_run_in_chs)(char32_t * it);
+	Byte_t * (* Scan_past_ppnum_run_in_bytes)(Byte_t * it, Byte_t * end);
+
+	Byte_t * (* Scan_line_starts_in_bytes)(Byte_t * it, Byte_t * end, Byte_t * begin, uint32_t ** offs_r, uint32_t * offs_end);
+} Kernels_t;
+
+static const Kernels_t kernels_scalar =
+{
+	Isa_scalar,
+	Len_leading_ascii_scalar,
+	Scan_toward_chs_in_chs_scalar,
+	Scan_toward_chs_in_bytes_scalar,
+	Scan_toward_triggers_in_bytes_scalar,
+	Scan_past_ws_in_chs_scalar,
+	Scan_past_ws_in_bytes_scalar,
+	Scan_past_id_run_in_chs_scalar,
+	Scan_past_id_run_in_bytes_scalar,
+	Scan_past_ppnum_run_in_chs_scalar,
+	Scan_past_ppnum_run_in_bytes_scalar,
+	Scan_line_starts_in_bytes_scalar,
+};
+
+#define KERNELS_SIMD(isa, Isa) \
+	{ \
+		isa, \
+		Len_leading_ascii_simd<Isa>, \
+		Scan_toward_chs_in_chs_simd<Isa>, \
+		Scan_toward_chs_in_bytes_simd<Isa>, \
+		Scan_toward_triggers_in_bytes_simd<Isa>, \
+		Scan_past_ws_in_chs_simd<Isa>, \
+		Scan_past_ws_in_bytes_simd<Isa>, \
+		Scan_past_id_run_in_chs_simd<Isa>, \
+		Scan_past_id_run_in_bytes_simd<Isa>, \
+		Scan_past_ppnum_run_in_chs_simd<Isa>, \
+		Scan_past_ppnum_run_in_bytes_simd<Isa>, \
+		Scan_line_starts_in_bytes_simd<Isa>, \
+	}
+
+static const Kernels_t kernels_sse2 = KERNELS_SIMD(Isa_sse2, Isa_sse2_t);
+static const Kernels_t kernels_avx2 = KERNELS_SIMD(Isa_avx2, Isa_avx2_t);
+static const Kernels_t kernels_avx512 = KERNELS_SIMD(Isa_avx512, Isa_avx512_t);
+
+#undef KERNELS_SIMD
+
+const Kernels_t * Kernels_from_isa(Isa_k isa)
+{
+	switch (isa)
+	{
+	case Isa_scalar: return &kernels_scalar;
+	case Isa_sse2: return &kernels_sse2;
+	case Isa_avx2: return &kernels_avx2;
+	case Isa_avx512: return &kernels_avx512;
+	}
+
+	return &kernels_sse2;
+}
+
+size_t Len_leading_ascii(
+	const Kernels_t * kernels_r,
+	Byte_span_t span)
+{
+	// NOTE we stop at the first non-ascii byte
+
+	return kernels_r->Len_leading_ascii(span);
+}
+
+
+
+// utf8 decode : convert a byte_span into a Ch_loc_ary
+
+typedef struct Ch_len_t // ch + len
+{
+	char32_t ch;
+	size_t len;
+} Ch_len_t;
+
+Ch_len_t Make_ch_len(char32_t ch, size_t len)
+{
+	Ch_len_t result = {ch, len};
+	return result;
+}
+
+// The lexer's runtime knobs, see 'env' below
+
+typedef struct Lex_env_t Lex_env_t;
+
+typedef struct Ch_loc_ary_t // chs + locs
+{
+	// Struct of arrays, so passes that only care about chs
+	//  (like the lexer) do not have to drag locs through the cache.
+	//  locs are stored as byte offsets from the start of the decoded span,
+	//  so each ch costs 8 bytes total instead of 16.
+
+	char32_t * chs;
+	uint32_t * offs;
+	size_t len; // not counting the trailing Mch_end
+
+	Byte_span_t span; // offs are relative to span.begin
+
+	const Lex_env_t * env_r; // for lexing the ary (see Env_from_it)
+} Ch_loc_ary_t;
+
+// Extra chs allocated past the end of a Ch_loc_ary_t, so simd scans
+//  can load whole blocks (up to 64 chs, for avx512) without checking for the end first
+
+static const size_t ch_ary_pad = 64;
+
+typedef enum Mch_k // Meta ch
+{
+	Mch_invalid = 0x110000, // 0x10FFFF + 1, signifies an encoding error
+	Mch_end,				// signifies the end of input bytes
+} Mch_k;
+
+// Utf8 byte classes and decoder states, for the table driven decoder below.
+//  This is the same idea as Bjoern Hoehrmann's "Flexible and Economical UTF-8 Decoder",
+//  we just spell out the classes and states.
+
+typedef enum Utf8c_k // utf8 byte class
+{
+	Utf8c_ascii,	// 00..7F
+	Utf8c_tail_lo,	// 80..8F
+	Utf8c_tail_mid,	// 90..9F
+	Utf8c_tail_hi,	// A0..BF
+	Utf8c_bad,		// C0..C1, F5..FF (never valid)
+	Utf8c_lead_2,	// C2..DF
+	Utf8c_e0,		// E0
+	Utf8c_lead_3,	// E1..EC, EE..EF
+	Utf8c_ed,		// ED
+	Utf8c_f0,		// F0
+	Utf8c_lead_4,	// F1..F3
+	Utf8c_f4,		// F4
+
+	Utf8c_max
+} Utf8c_k;
+
+typedef enum Utf8s_k // utf8 decoder state
+{
+	Utf8s_accept,	// Not in the middle of a code point
+	Utf8s_reject,	// Encoding error
+	Utf8s_tail_1,	// Need 1 more 80..BF
+	Utf8s_tail_2,	// Need 2 more 80..BF
+	Utf8s_tail_3,	// Need 3 more 80..BF
+	Utf8s_e0,		// Need A0..BF, then 1 more (rejects overlong 3 byte encodings)
+	Utf8s_ed,		// Need 80..9F, then 1 more (rejects utf16 surrogates)
+	Utf8s_f0,		// Need 90..BF, then 2 more (rejects overlong 4 byte encodings)
+	Utf8s_f4,		// Need 80..8F, then 2 more (rejects anything > 0x10FFFF)
+
+	Utf8s_max
+} Utf8s_k;
+
+Ch_len_t Decode_leading_ch(Byte_span_t span)
+{
+	// Decode_leading_ch is a state machine driven by the class of each byte.
+	//  The transitions are Table 3-7 (Well-Formed UTF-8 Byte Sequences)
+	//  from the unicode standard, which rejects 'overlong encodings'
+	//  (that is, using more bytes than necessary/allowed for a given code point),
+	//  utf16 surrogates ([0xD800, 0xDFFF]), and anything > 0x10FFFF.
+
+	/*
+		utf8 can encode up to 21 bits like this
+
+		1-byte = 0 to 7 bits : 		0xxxxxxx
+		2-byte = 8 to 11 bits :		110xxxxx 10xxxxxx
+		3-byte = 12 to 16 bits :	1110xxxx 10xxxxxx 10xxxxxx
+		4-byte = 17 to 21 bits :	11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+
+		Note that, 2/3/4 byte values start with a byte with 2/3/4 leading ones.
+		That is how you decode them later. (the trailing bytes all start with '10')
+	*/
+
+	static const Byte_t utf8c_from_byte[256] =
+	{
+		// 00..7F
+
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+
+		// 80..BF
+
+		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+		2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+		3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+		3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+
+		// C0..DF
+
+		4, 4, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+		5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+
+		// E0..EF
+
+		6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 7,
+
+		// F0..FF
+
+		9, 10, 10, 10, 11, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	};
+
+	// Significant bits of the first byte, by class
+
+	static const Byte_t lead_mask_from_utf8c[Utf8c_max] =
+	{
+		0x7F, 0, 0, 0, 0, 0x1F, 0x0F, 0x0F, 0x0F, 0x07, 0x07, 0x07
+	};
+
+	#define REJ Utf8s_reject
+	static const Byte_t utf8s_next[Utf8s_max][Utf8c_max] =
+	{
+		// ascii, tail_lo, tail_mid, tail_hi, bad, lead_2, e0, lead_3, ed, f0, lead_4, f4
+
+		/* accept */ { Utf8s_accept, REJ, REJ, REJ, REJ, Utf8s_tail_1, Utf8s_e0, Utf8s_tail_2, Utf8s_ed, Utf8s_f0, Utf8s_tail_3, Utf8s_f4 },
+		/* reject */ { REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ },
+		/* tail_1 */ { REJ, Utf8s_accept, Utf8s_accept, Utf8s_accept, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ },
+		/* tail_2 */ { REJ, Utf8s_tail_1, Utf8s_tail_1, Utf8s_tail_1, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ },
+		/* tail_3 */ { REJ, Utf8s_tail_2, Utf8s_tail_2, Utf8s_tail_2, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ },
+		/* e0 */     { REJ, REJ, REJ, Utf8s_tail_1, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ },
+		/* ed */     { REJ, Utf8s_tail_1, Utf8s_tail_1, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ },
+		/* f0 */     { REJ, REJ, Utf8s_tail_2, Utf8s_tail_2, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ },
+		/* f4 */     { REJ, Utf8s_tail_2, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ, REJ },
+	};
+	#undef REJ
+
+	// Check if we have no bytes at all
+
+	size_t span_len = Byte_span_len(span);
+	if (span_len == 0)
+		return Make_ch_len(Mch_end, 0);
+
+	// Run the state machine until we accept or reject.
+	//  No valid sequence is longer than 4 bytes, so we never need more than that.
+
+	// NOTE that any error (including running out of bytes) is reported
+	//  as a single invalid byte, so we resync on the very next byte
+
+	size_t len_max = (span_len < 4) ? span_len : 4;
+
+	Byte_t state = Utf8s_accept;
+	char32_t ch = 0;
+
+	for (size_t i = 0; i < len_max; ++i)
+	{
+		Byte_t byte = span.begin[i];
+		Byte_t utf8c = utf8c_from_byte[byte];
+
+		if (i == 0)
+		{
+			ch = byte & lead_mask_from_utf8c[utf8c];
+		}
+		else
+		{
+			ch = (ch << 6) | (byte & 0x3F);
+		}
+
+		state = utf8s_next[state][utf8c];
+
+		if (state == Utf8s_accept)
+			return Make_ch_len(ch, i + 1);
+
+		if (state == Utf8s_reject)
+			break;
+	}
+
+	return Make_ch_len(Mch_invalid, 1);
+}
+
+Ch_loc_ary_t Decode_byte_span(
+	const Kernels_t * kernels_r,
+	Arena_t * arena_r,
+	Byte_span_t span,
+	size_t off_start)
+{
+	// Decode span, starting off_start bytes in.
+	//  off_start must be the loc of a ch.
+
+	// Remember where we started, offs are relative to this
+
+	Byte_t * span_begin = span.begin;
+
+	size_t span_len = Byte_span_len(span);
+
+	// offs are 32 bits
+
+	assert(span_len < UINT32_MAX);
+
+	assert(off_start <= span_len);
+	span.begin += off_start;
+	span_len -= off_start;
+
+	// Deal with potential UTF-8 BOM (only at the very start)
+
+	if (off_start == 0 &&
+		span_len >= 3 &&
+		span.begin[0] == 0xEF &&
+		span.begin[1] == 0xBB &&
+		span.begin[2] == 0xBF)
+	{
+		span.begin += 3;
+		span_len -= 3;
+	}
+
+	// Allocate space for ch_locs
+	//  In the worst case, we will have a ch_loc for every byte
+	//  in byte_span. Note that we allocate 1 extra ch_loc, so
+	//  we have room for a trailing Mch_end
+
+	// NOTE chs and offs share one allocation, offs come right after chs
+	//  (and ch_ary_pad chs of padding). It is not zeroed, nothing reads past
+	//  the trailing Mch_end except simd scans, which always stop at it
+
+	Ch_loc_ary_t ary = {};
+	size_t ary_len = span_len + 1;
+	{
+		size_t size = sizeof(char32_t) + sizeof(uint32_t);
+		ary.chs = (char32_t *)Alloc_arena(arena_r, (ary_len + ch_ary_pad) * size);
+		ary.offs = (uint32_t *)(ary.chs + ary_len + ch_ary_pad);
+	}
+
+	ary.span.begin = span_begin;
+	ary.span.end = span.end;
+
+	// Chew through the byte span with Decode_leading_ch,
+	//  until we get to Mch_end.
+
+	size_t i_ch = 0;
+	while (true)
+	{
+		// Copy any leading ascii over in bulk, 
+		//  so we only call Decode_leading_ch when we have to
+
+		size_t len_ascii = Len_leading_ascii(kernels_r, span);
+		uint32_t off = (uint32_t)(span.begin - span_begin);
+		for (size_t i = 0; i < len_ascii; ++i)
+		{
+			ary.chs[i_ch + i] = span.begin[i];
+			ary.offs[i_ch + i] = off + (uint32_t)i;
+		}
+
+		i_ch += len_ascii;
+		span.begin += len_ascii;
+
+		assert(i_ch < ary_len);
+
+		// Decode
+		
+		Ch_len_t ch_len = Decode_leading_ch(span);
+
+		// Add to ary
+
+		ary.chs[i_ch] = ch_len.ch;
+		ary.offs[i_ch] = (uint32_t)(span.begin - span_begin);
+
+		// Check for Mch_end
+
+		// NOTE we are letting Mch_invalid through here on purpose,
+		//  so it can be handled by calling code
+
+		if (ch_len.ch == Mch_end)
+		{
+			ary.len = i_ch;
+			break;
+		}
+
+		// Advance
+
+		++i_ch;
+		span.begin += ch_len.len;
+	}
+
+	// Return the ary
+
+	return ary;
+}
+
+
+
+// 'scrub' : replace patterns in ch_loc_ary
+
+// Each pass is written as a function that scrubs the leading ch(s),
+//  so passes can be chained together and run on demand
+//  (Phase_scrub_t, see 'cursor' below).
+
+// Scrub must have Scrub_peek_ch, Advance_scrub and Skip_scrub.
+//  Scrub_peek_ch is never called past Mch_end, and the callers
+//  deal with Mch_end themselves.
+
+template <typename Scrub>
+void Scrub_leading_carriage_return(Scrub * scrub_r)
+{
+	char32_t ch = Scrub_peek_ch(*scrub_r, 0);
+	bool is_cr = ch == '\r';
+	if (is_cr)
+		ch = '\n';
+
+	size_t len = 1;
+	if (is_cr && Scrub_peek_ch(*scrub_r, 1) == '\n')
+	{
+		len = 2;
+	}
+
+	Advance_scrub(scrub_r, ch, len);
+}
+
+template <typename Scrub>
+void Scrub_leading_trigraph(Scrub * scrub_r)
+{
+	char32_t ch0 = Scrub_peek_ch(*scrub_r, 0);
+
+	if (ch0 == '?' && Scrub_peek_ch(*scrub_r, 1) == '?')
+	{
+		char32_t ch2 = Scrub_peek_ch(*scrub_r, 2);
+
+		char32_t pairs[][2] =
+		{
+			{ '<', '{' },
+			{ '>', '}' },
+			{ '(', '[' },
+			{ ')', ']' },
+			{ '=', '#' },
+			{ '/', '\\' },
+			{ '\'', '^' },
+			{ '!', '|' },
+			{ '-', '~' },
+		};
+
+		int i_match = -1;
+		for (int i = 0; i < ARY_LEN(pairs); ++i)
+		{
+			if (pairs[i][0] == ch2)
+			{
+				i_match = i;
+				break;
+			}
+		}
+
+		if (i_match != -1)
+		{
+			char32_t ch_replace = pairs[i_match][1];
+			Advance_scrub(scrub_r, ch_replace, 3);
+
+			return;
+		}
+	}
+
+	Advance_scrub(scrub_r, ch0, 1);
+}
+
+template <typename Scrub>
+void Scrub_leading_escaped_line_breaks(Scrub * scrub_r)
+{
+	// Get length of leading esc eols
+
+	size_t len = 0;
+	while (true)
+	{
+		size_t i = len;
+		if (Scrub_peek_ch(*scrub_r, i) != '\\')
+			break;
+
+		++i;
+
+		while (Is_hz_ws(Scrub_peek_ch(*scrub_r, i)))
+		{
+			++i;
+		}
+
+		// Do not need to check for \r. since that 
+		//  has already been scrubbed.
+
+		if (Scrub_peek_ch(*scrub_r, i) != '\n')
+			break;
+
+		len = i + 1;
+	}
+
+	// Advance now that we have the length
+
+	if (len == 0)
+	{
+		Advance_scrub(scrub_r, Scrub_peek_ch(*scrub_r, 0), 1);
+	}
+	else if (Scrub_peek_ch(*scrub_r, len) == Mch_end)
+	{
+		// Drop trailing escaped line break
+		//  (do not include it in a character)
+
+		// BUG this is too clever
+		
+		Skip_scrub(scrub_r, len);
+	}
+	else
+	{
+		Advance_scrub(
+			scrub_r,
+			Scrub_peek_ch(*scrub_r, len),
+			len + 1);
+	}
+}
+
+// 'cursor' : decode + scrub on demand, instead of materializing a whole ch_loc_ary.
+//  Each 'phase' (decode, then each scrub pass) pulls chs from the phase before it
+//  only when it needs them, and queues up its own output for the next phase.
+
+typedef struct Ch_queue_t
+{
+	// Ring buffer of ch_locs. i_begin and i_end only ever go up,
+	//  so we mask them with (cap - 1) to find a slot
+
+	char32_t * chs;
+	uint32_t * offs;
+	size_t cap;
+	size_t i_begin;
+	size_t i_end;
+
+	Arena_t * arena_r; // where to grow into
+} Ch_queue_t;
+
+size_t Queue_len(Ch_queue_t * queue_r)
+{
+	return queue_r->i_end - queue_r->i_begin;
+}
+
+size_t Queue_slot(Ch_queue_t * queue_r, size_t i)
+{
+	return i & (queue_r->cap - 1);
+}
+
+void Grow_queue(Ch_queue_t * queue_r)
+{
+	// Double cap (cap is always a power of 2)
+
+	size_t cap = (queue_r->cap) ? queue_r->cap * 2 : 16;
+
+	char32_t * chs = (char32_t *)Alloc_arena(queue_r->arena_r, cap * sizeof(char32_t));
+	uint32_t * offs = (uint32_t *)Alloc_arena(queue_r->arena_r, cap * sizeof(uint32_t));
+
+	// Copy over queued ch_locs. Slots move, since the mask changes
+
+	for (size_t i = queue_r->i_begin; i < queue_r->i_end; ++i)
+	{
+		size_t slot_old = Queue_slot(queue_r, i);
+		size_t slot_new = i & (cap - 1);
+
+		chs[slot_new] = queue_r->chs[slot_old];
+		offs[slot_new] = queue_r->offs[slot_old];
+	}
+
+	// Old slots just sit in the arena until it is reset
+
+	queue_r->chs = chs;
+	queue_r->offs = offs;
+	queue_r->cap = cap;
+}
+
+void Push_queue(
+	Ch_queue_t * queue_r, 
+	char32_t ch, 
+	uint32_t off)
+{
+	if (Queue_len(queue_r) == queue_r->cap)
+	{
+		Grow_queue(queue_r);
+	}
+
+	size_t slot = Queue_slot(queue_r, queue_r->i_end);
+	queue_r->chs[slot] = ch;
+	queue_r->offs[slot] = off;
+
+	++queue_r->i_end;
+}
+
+void Pop_queue(
+	Ch_queue_t * queue_r, 
+	size_t len)
+{
+	assert(len <= Queue_len(queue_r));
+
+	queue_r->i_begin += len;
+}
+
+void Reset_queue(
+	Ch_queue_t * queue_r,
+	size_t i)
+{
+	queue_r->i_begin = i;
+	queue_r->i_end = i;
+}
+
+typedef enum Phase_k
+{
+	Phase_decode,
+	Phase_carriage_returns,
+	Phase_trigraphs,
+	Phase_escaped_line_breaks,
+
+	Phase_max
+} Phase_k;
+
+typedef struct Cursor_t
+{
+	Byte_t * span_begin;	// offs are relative to this
+	Byte_span_t span;		// bytes we have not decoded yet
+
+	// If ary.chs is set, Phase_decode pulls already decoded chs
+	//  from ary (starting at i_ary) instead of decoding span
+
+	Ch_loc_ary_t ary;
+	size_t i_ary;
+
+	// Scrub phases we know will not change anything (see Scan_for_scrub),
+	//  these just pass chs through
+
+	bool skip_phase[Phase_max];
+
+	// Output of each phase, waiting to be pulled by the next phase.
+	//  The output of the last phase is a 'window' of the final chs,
+	//  indexed by the ch's index in the whole file.
+
+	Ch_queue_t queues[Phase_max];
+
+	// A ch we know how to restart from (see Restart_cursor),
+	//  and the offset of the very first ch (after any BOM)
+
+	size_t i_ch_mark;
+	uint32_t off_mark;
+	uint32_t off_first;
+
+	const Lex_env_t * env_r; // for lexing with the cursor (see Env_from_it)
+} Cursor_t;
+
+// How many final chs we keep around, so the lexer can look back at them.
+//  The lexer never looks back further than the start of the current token,
+//  and only ever that far after peeking at a ucn, so this is plenty.
+
+static const size_t cursor_window_len = 256;
+
+Cursor_t Start_cursor(
+	Arena_t * arena_r,
+	Byte_span_t span)
+{
+	Cursor_t cursor = {};
+	cursor.span_begin = span.begin;
+
+	for (int phase = 0; phase < Phase_max; ++phase)
+	{
+		cursor.queues[phase].arena_r = arena_r;
+	}
+
+	// Deal with potential UTF-8 BOM
+
+	size_t span_len = Byte_span_len(span);
+
+	// offs are 32 bits
+
+	assert(span_len < UINT32_MAX);
+
+	if (span_len >= 3 &&
+		span.begin[0] == 0xEF &&
+		span.begin[1] == 0xBB &&
+		span.begin[2] == 0xBF)
+	{
+		span.begin += 3;
+	}
+
+	cursor.span = span;
+
+	cursor.off_first = (uint32_t)(span.begin - cursor.span_begin);
+	cursor.i_ch_mark = 0;
+	cursor.off_mark = cursor.off_first;
+
+	// Window does not need to grow
+
+	while (cursor.queues[Phase_max - 1].cap < cursor_window_len)
+	{
+		Grow_queue(&cursor.queues[Phase_max - 1]);
+	}
+
+	return cursor;
+}
+
+void Produce_phase(
+	Cursor_t * cursor_r, 
+	Phase_k phase);
+
+char32_t Peek_phase_ch(
+	Cursor_t * cursor_r, 
+	Phase_k phase, 
+	size_t i)
+{
+	Ch_queue_t * queue_r = &cursor_r->queues[phase];
+	while (Queue_len(queue_r) <= i)
+	{
+		Produce_phase(cursor_r, phase);
+	}
+
+	return queue_r->chs[Queue_slot(queue_r, queue_r->i_begin + i)];
+}
+
+typedef struct Phase_scrub_t
+{
+	Cursor_t * cursor_r;
+	Phase_k phase; // phase we are producing chs for
+} Phase_scrub_t;
+
+char32_t Scrub_peek_ch(Phase_scrub_t scrub, size_t i)
+{
+	return Peek_phase_ch(
+			scrub.cursor_r, 
+			(Phase_k)(scrub.phase - 1), 
+			i);
+}
+
+void Advance_scrub(
+	Phase_scrub_t * scrub_r,
+	char32_t ch,
+	size_t len)
+{
+	Ch_queue_t * queue_from_r = &scrub_r->cursor_r->queues[scrub_r->phase - 1];
+	Ch_queue_t * queue_to_r = &scrub_r->cursor_r->queues[scrub_r->phase];
+
+	uint32_t off = queue_from_r->offs[Queue_slot(queue_from_r, queue_from_r->i_begin)];
+
+	Push_queue(queue_to_r, ch, off);
+	Pop_queue(queue_from_r, len);
+}
+
+void Skip_scrub(
+	Phase_scrub_t * scrub_r,
+	size_t len)
+{
+	Pop_queue(&scrub_r->cursor_r->queues[scrub_r->phase - 1], len);
+}
+
+void Produce_phase(
+	Cursor_t * cursor_r, 
+	Phase_k phase)
+{
+	// Produce (at most) one more ch for phase
+
+	// NOTE Mch_end is never popped, so once a phase sees it,
+	//  it keeps producing Mch_end (with the loc of the end of the span)
+
+	if (phase == Phase_decode && cursor_r->ary.chs)
+	{
+		char32_t ch = cursor_r->ary.chs[cursor_r->i_ary];
+		uint32_t off = cursor_r->ary.offs[cursor_r->i_ary];
+
+		Push_queue(&cursor_r->queues[phase], ch, off);
+		if (ch != Mch_end)
+		{
+			++cursor_r->i_ary;
+		}
+
+		return;
+	}
+
+	if (phase == Phase_decode)
+	{
+		Ch_len_t ch_len = Decode_leading_ch(cursor_r->span);
+		uint32_t off = (uint32_t)(cursor_r->span.begin - cursor_r->span_begin);
+
+		Push_queue(&cursor_r->queues[phase], ch_len.ch, off);
+		cursor_r->span.begin += ch_len.len;
+
+		return;
+	}
+
+	Phase_scrub_t scrub = {cursor_r, phase};
+
+	if (Scrub_peek_ch(scrub, 0) == Mch_end)
+	{
+		Advance_scrub(&scrub, Mch_end, 0);
+		return;
+	}
+
+	if (cursor_r->skip_phase[phase])
+	{
+		Advance_scrub(&scrub, Scrub_peek_ch(scrub, 0), 1);
+		return;
+	}
+
+	switch (phase)
+	{
+	case Phase_carriage_returns:
+		Scrub_leading_carriage_return(&scrub);
+		break;
+
+	case Phase_trigraphs:
+		Scrub_leading_trigraph(&scrub);
+		break;
+
+	default: // Phase_escaped_line_breaks
+		Scrub_leading_escaped_line_breaks(&scrub);
+		break;
+	}
+}
+
+void Seek_cursor(
+	Cursor_t * cursor_r,
+	size_t i_ch,
+	uint32_t off)
+{
+	// Throw away everything queued up, and start decoding again at off.
+	//  The next final ch will be i_ch.
+
+	// NOTE off must be the loc of a final ch (or somewhere scrubbing
+	//  would start fresh anyway), or we will get different chs
+
+	for (int phase = 0; phase < Phase_max - 1; ++phase)
+	{
+		Reset_queue(&cursor_r->queues[phase], 0);
+	}
+
+	Reset_queue(&cursor_r->queues[Phase_max - 1], i_ch);
+
+	cursor_r->span.begin = cursor_r->span_begin + off;
+}
+
+void Restart_cursor(
+	Cursor_t * cursor_r, 
+	size_t i_ch)
+{
+	// We get here if someone asks for a ch that has already fallen out of the window.
+	//  Decoding + scrubbing from the loc of any final ch gives the same chs as the
+	//  first time (each phase started consuming that ch's bytes right at its loc),
+	//  so we go back to the latest mark before i_ch, and pull chs from there again.
+
+	size_t i_ch_restart = 0;
+	uint32_t off_restart = cursor_r->off_first;
+
+	if (i_ch >= cursor_r->i_ch_mark)
+	{
+		i_ch_restart = cursor_r->i_ch_mark;
+		off_restart = cursor_r->off_mark;
+	}
+
+	Seek_cursor(cursor_r, i_ch_restart, off_restart);
+}
+
+size_t Cursor_slot(
+	Cursor_t * cursor_r, 
+	size_t i_ch)
+{
+	// Make sure i_ch is in the window, and return its slot
+
+	Ch_queue_t * window_r = &cursor_r->queues[Phase_max - 1];
+
+	if (i_ch < window_r->i_begin)
+	{
+		Restart_cursor(cursor_r, i_ch);
+	}
+
+	while (i_ch >= window_r->i_end)
+	{
+		// Window never grows, drop the oldest ch to make room
+
+		if (Queue_len(window_r) == cursor_window_len)
+		{
+			Pop_queue(window_r, 1);
+		}
+
+		Produce_phase(cursor_r, (Phase_k)(Phase_max - 1));
+	}
+
+	return Queue_slot(window_r, i_ch);
+}
+
+char32_t Cursor_ch(
+	Cursor_t * cursor_r, 
+	size_t i_ch)
+{
+	size_t slot = Cursor_slot(cursor_r, i_ch);
+	return cursor_r->queues[Phase_max - 1].chs[slot];
+}
+
+uint32_t Cursor_off(
+	Cursor_t * cursor_r, 
+	size_t i_ch)
+{
+	size_t slot = Cursor_slot(cursor_r, i_ch);
+	return cursor_r->queues[Phase_max - 1].offs[slot];
+}
+
+void Mark_cursor(
+	Cursor_t * cursor_r, 
+	size_t i_ch)
+{
+	// Remember i_ch as a place to restart from.
+	//  Callers should mark the start of each token,
+	//  since the lexer never looks back before that.
+
+	cursor_r->off_mark = Cursor_off(cursor_r, i_ch);
+	cursor_r->i_ch_mark = i_ch;
+}
+
+typedef struct Cursor_it_t
+{
+	// Lets the lexer walk a cursor just like it walks a char32_t *
+
+	Cursor_t * cursor_r;
+	size_t i_ch;
+
+	char32_t operator*() const
+	{
+		return Cursor_ch(cursor_r, i_ch);
+	}
+
+	char32_t operator[](size_t i) const
+	{
+		return Cursor_ch(cursor_r, i_ch + i);
+	}
+
+	Cursor_it_t & operator++()
+	{
+		++i_ch;
+		return *this;
+	}
+
+	Cursor_it_t & operator+=(size_t len)
+	{
+		i_ch += len;
+		return *this;
+	}
+
+	Cursor_it_t operator+(size_t len) const
+	{
+		Cursor_it_t result = {cursor_r, i_ch + len};
+		return result;
+	}
+} Cursor_it_t;
+
+// Raw bytes under an It, for C++ raw strings (see Lex_rest_of_raw_str_lit).
+//  Raw_span_from_it gives the bytes from the loc of the ch at it, up to the end
+//  of what it can see. Seek_raw_loc moves it forward to the ch at loc.
+
+// NOTE loc must be somewhere scrubbing would start fresh, see Seek_cursor
+
+Byte_span_t Raw_span_from_it(Cursor_it_t it)
+{
+	Cursor_t * cursor_r = it.cursor_r;
+	Byte_span_t span = {cursor_r->span_begin + Cursor_off(cursor_r, it.i_ch), cursor_r->span.end};
+	return span;
+}
+
+const Lex_env_t * Env_from_it(Cursor_it_t it)
+{
+	return it.cursor_r->env_r;
+}
+
+Cursor_it_t Seek_raw_loc(
+	Cursor_it_t it,
+	Byte_t * loc)
+{
+	// Chs are only ever numbered in order, so we just need a number past
+	//  every ch we skipped (the byte count will do), and the callers mark
+	//  the next token before anyone could look back past it.
+
+	Cursor_t * cursor_r = it.cursor_r;
+	Byte_t * loc_it = cursor_r->span_begin + Cursor_off(cursor_r, it.i_ch);
+	if (loc == loc_it)
+		return it;
+
+	it.i_ch += (size_t)(loc - loc_it);
+	Seek_cursor(cursor_r, it.i_ch, (uint32_t)(loc - cursor_r->span_begin));
+	return it;
+}
+
+
+
+
+// 'scan' : figure out which scrub passes a byte_span actually needs,
+//  before we decode it
+
+typedef struct Scrub_scan_t
+{
+	bool has_carriage_returns;
+	bool has_trigraphs;
+	bool has_escaped_line_breaks;
+
+	// Offset of the first byte that starts something we need to scrub
+	//  (the length of the span if there is nothing to scrub)
+
+	size_t off_first;
+} Scrub_scan_t;
+
+bool Is_trigraph_suffix(Byte_t byte)
+{
+	// Third byte of a trigraph ("??" + this)
+
+	switch (byte)
+	{
+	case '<': case '>': case '(': case ')': case '=':
+	case '/': case '\'': case '!': case '-':
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+bool Is_escaped_line_break_suffix(
+	Byte_t * it,
+	Byte_t * end)
+{
+	// Check if a backslash followed by these bytes would be
+	//  an escaped line break (hz whitespace, then a line break)
+
+	while (it < end && Is_hz_ws(*it))
+	{
+		++it;
+	}
+
+	return it < end && (*it == '\n' || *it == '\r');
+}
+
+void Scan_leading_scrub_pattern(
+	Scrub_scan_t * scan_r,
+	Byte_span_t span,
+	size_t off,
+	bool trigraphs)
+{
+	// Check if the byte at off starts a pattern we need to scrub.
+
+	// NOTE we look at raw bytes, not decoded chs. That is fine, since all the
+	//  patterns are ascii, and ascii bytes always decode to themselves.
+	//  Also, no pattern can produce a ch that starts another pattern,
+	//  except "??/" (which is checked for here as an escaped line break too)
+
+	Byte_t * it = span.begin + off;
+	Byte_t * end = span.end;
+
+	bool found = false;
+
+	if (*it == '\r')
+	{
+		scan_r->has_carriage_returns = true;
+		found = true;
+	}
+	else if (*it == '\\')
+	{
+		if (Is_escaped_line_break_suffix(it + 1, end))
+		{
+			scan_r->has_escaped_line_breaks = true;
+			found = true;
+		}
+	}
+	else if (trigraphs && *it == '?' && end - it >= 3 && it[1] == '?' && Is_trigraph_suffix(it[2]))
+	{
+		scan_r->has_trigraphs = true;
+		found = true;
+
+		if (it[2] == '/' && Is_escaped_line_break_suffix(it + 3, end))
+		{
+			scan_r->has_escaped_line_breaks = true;
+		}
+	}
+
+	if (found && off < scan_r->off_first)
+	{
+		scan_r->off_first = off;
+	}
+}
+
+Scrub_scan_t Scan_for_scrub(
+	const Kernels_t * kernels_r,
+	Byte_span_t span,
+	bool trigraphs)
+{
+	// trigraphs is false for languages without them, so "??" never counts
+	size_t span_len = Byte_span_len(span);
+
+	Scrub_scan_t scan = {false, false, false, span_len};
+
+	// Jump from candidate to candidate ('\r', '\\', or '?' if we have trigraphs),
+	//  and check each one properly. Once we know we need a pass, we stop looking
+	//  for its candidates, and once we need every pass we are done.
+
+	Byte_t * it = span.begin;
+	while (true)
+	{
+		char cands[3];
+		int len_cands = 0;
+
+		if (!scan.has_carriage_returns)
+		{
+			cands[len_cands++] = '\r';
+		}
+
+		if (!scan.has_escaped_line_breaks)
+		{
+			cands[len_cands++] = '\\';
+		}
+
+		// "??/" can also be the backslash of an escaped line break
+
+		if (trigraphs && (!scan.has_trigraphs || !scan.has_escaped_line_breaks))
+		{
+			cands[len_cands++] = '?';
+		}
+
+		if (!len_cands)
+			break;
+
+		// Repeat the last cand to fill out all 3
+
+		it = kernels_r->Scan_toward_triggers_in_bytes(
+							it,
+							span.end,
+							cands[0],
+							cands[(len_cands > 1) ? 1 : 0],
+							cands[len_cands - 1]);
+
+		if (it == span.end)
+			break;
+
+		Scan_leading_scrub_pattern(&scan, span, (size_t)(it - span.begin), trigraphs);
+		++it;
+	}
+
+	return scan;
+}
+
+void Print_scrub_stats(
+	Scrub_scan_t scan,
+	size_t span_len)
+{
+	// Print which scrub passes we ran, to stderr so it does not mix with the tokens
+
+	fprintf(
+		stderr,
+		"scrub: carriage returns %s, trigraphs %s, escaped line breaks %s\n",
+		scan.has_carriage_returns ? "run" : "skipped",
+		scan.has_trigraphs ? "run" : "skipped",
+		scan.has_escaped_line_breaks ? "run" : "skipped");
+
+	if (scan.off_first < span_len)
+	{
+		fprintf(
+			stderr,
+			"scrub: started at byte %zu of %zu\n",
+			scan.off_first,
+			span_len);
+	}
+	else
+	{
+		fprintf(stderr, "scrub: skipped\n");
+	}
+}
+
+
+
+// Scrub a whole ch_loc_ary in place, in one pass
+
+bool Is_scrub_trigger(
+	Cursor_t * cursor_r,
+	char32_t ch)
+{
+	// Chs which might start a pattern that one of the (not skipped) scrub passes replaces.
+	//  Anything else comes out of all three passes unchanged.
+
+	if (ch == Mch_end)
+		return true;
+
+	if (ch == '\r')
+		return !cursor_r->skip_phase[Phase_carriage_returns];
+
+	if (ch == '?')
+		return !cursor_r->skip_phase[Phase_trigraphs];
+
+	if (ch == '\\')
+		return !cursor_r->skip_phase[Phase_escaped_line_breaks];
+
+	return false;
+}
+
+bool Are_phases_empty(Cursor_t * cursor_r)
+{
+	for (int phase = 0; phase < Phase_max; ++phase)
+	{
+		if (Queue_len(&cursor_r->queues[phase]))
+			return false;
+	}
+
+	return true;
+}
+
+void Scrub_ary(
+	Ch_loc_ary_t * ary_r,
+	Scrub_scan_t scan,
+	Arena_t * arena_r)
+{
+	// Does carriage returns, trigraphs and escaped line breaks
+	//  (translation phases 1 and 2) in one walk over ary,
+	//  with the same result as doing each pass over the whole ary in turn.
+
+	// Nothing to scrub? we are done
+
+	if (!scan.has_carriage_returns &&
+		!scan.has_trigraphs &&
+		!scan.has_escaped_line_breaks)
+	{
+		return;
+	}
+
+	// Most chs do not trigger any pass, so we copy those over directly.
+	//  When we do hit a trigger, we pull chs through the same phases
+	//  the lazy cursor uses, until the phases are empty again.
+
+	// NOTE we can scrub in place, since every final ch consumes
+	//  at least one ch from ary, so we never write past where we have read
+
+	Ch_loc_ary_t ary = *ary_r;
+
+	Cursor_t cursor = {};
+	cursor.ary = ary;
+
+	for (int phase = 0; phase < Phase_max; ++phase)
+	{
+		cursor.queues[phase].arena_r = arena_r;
+	}
+
+	cursor.skip_phase[Phase_carriage_returns] = !scan.has_carriage_returns;
+	cursor.skip_phase[Phase_trigraphs] = !scan.has_trigraphs;
+	cursor.skip_phase[Phase_escaped_line_breaks] = !scan.has_escaped_line_breaks;
+
+	// Everything before scan.off_first comes through unchanged,
+	//  so start at the first ch at or after it. offs only go up,
+	//  so we can binary search for it
+
+	size_t i_lo = 0;
+	size_t i_hi = ary.len;
+	while (i_lo < i_hi)
+	{
+		size_t i_mid = i_lo + (i_hi - i_lo) / 2;
+		if (ary.offs[i_mid] < scan.off_first)
+		{
+			i_lo = i_mid + 1;
+		}
+		else
+		{
+			i_hi = i_mid;
+		}
+	}
+
+	cursor.i_ary = i_lo;
+
+	Phase_k phase_last = (Phase_k)(Phase_max - 1);
+	Ch_queue_t * window_r = &cursor.queues[phase_last];
+
+	size_t i_to = cursor.i_ary;
+	while (true)
+	{
+		// Fast path, nothing queued up, and a ch no pass cares about
+
+		if (Are_phases_empty(&cursor))
+		{
+			size_t i_from = cursor.i_ary;
+			while (!Is_scrub_trigger(&cursor, ary.chs[i_from]))
+			{
+				ary.chs[i_to] = ary.chs[i_from];
+				ary.offs[i_to] = ary.offs[i_from];
+
+				++i_to;
+				++i_from;
+			}
+
+			cursor.i_ary = i_from;
+		}
+
+		// Slow path, pull a ch through all the phases
+
+		char32_t ch = Peek_phase_ch(&cursor, phase_last, 0);
+		uint32_t off = window_r->offs[Queue_slot(window_r, window_r->i_begin)];
+
+		ary.chs[i_to] = ch;
+		ary.offs[i_to] = off;
+
+		if (ch == Mch_end)
+			break;
+
+		++i_to;
+		Pop_queue(window_r, 1);
+	}
+
+	ary_r->len = i_to;
+
+	// NOTE the queues are in arena_r, so nothing to clean up
+}
+
+
+// 'splice map' : lex the raw bytes directly, with a small side table
+//  for the few places where scrubbing changes anything
+
+typedef struct Splice_t
+{
+	// Bytes [off_begin, off_end) scrub down to the single ch 'ch'
+	//  (or to nothing at all, if ch is Mch_end)
+
+	uint32_t off_begin;
+	uint32_t off_end;
+	char32_t ch;
+} Splice_t;
+
+typedef struct Splice_map_t
+{
+	Byte_span_t span;
+	uint32_t off_first; // offset of the first ch (after any BOM)
+
+	// Sorted by off_begin, and never overlapping. 
+	//  Always ends with a splice that starts past the end of span,
+	//  so we never have to check if we ran out of splices
+
+	Splice_t * splices;
+	size_t len;
+	size_t cap;
+
+	Arena_t * arena_r; // where splices grows into
+
+	const Lex_env_t * env_r; // for lexing the map (see Env_from_it)
+} Splice_map_t;
+
+void Push_splice(
+	Splice_map_t * map_r,
+	uint32_t off_begin,
+	uint32_t off_end,
+	char32_t ch)
+{
+	if (map_r->len == map_r->cap)
+	{
+		size_t cap = (map_r->cap) ? map_r->cap * 2 : 16;
+
+		Splice_t * splices = (Splice_t *)Alloc_arena(map_r->arena_r, cap * sizeof(Splice_t));
+		for (size_t i = 0; i < map_r->len; ++i)
+		{
+			splices[i] = map_r->splices[i];
+		}
+
+		map_r->splices = splices;
+		map_r->cap = cap;
+	}
+
+	Splice_t splice = {off_begin, off_end, ch};
+	map_r->splices[map_r->len] = splice;
+	++map_r->len;
+}
+
+size_t Len_leading_non_trigger(
+	const Kernels_t * kernels_r,
+	Byte_span_t span,
+	Scrub_scan_t scan)
+{
+	// Count leading bytes which could not start anything a (not skipped) scrub pass replaces.
+	//  Same idea as Len_leading_ascii. Triggers are all ascii, so this never
+	//  stops in the middle of a utf8 sequence.
+
+	char triggers[3];
+	int len_triggers = 0;
+
+	if (scan.has_carriage_returns)
+	{
+		triggers[len_triggers++] = '\r';
+	}
+
+	if (scan.has_trigraphs)
+	{
+		triggers[len_triggers++] = '?';
+	}
+
+	if (scan.has_escaped_line_breaks)
+	{
+		triggers[len_triggers++] = '\\';
+	}
+
+	if (!len_triggers)
+		return Byte_span_len(span);
+
+	// Repeat the last trigger to fill out all 3
+
+	Byte_t * it = kernels_r->Scan_toward_triggers_in_bytes(
+							span.begin,
+							span.end,
+							triggers[0],
+							triggers[(len_triggers > 1) ? 1 : 0],
+							triggers[len_triggers - 1]);
+
+	return (size_t)(it - span.begin);
+}
+
+Splice_map_t Build_splice_map(
+	const Kernels_t * kernels_r,
+	Arena_t * arena_r,
+	Byte_span_t span,
+	bool trigraphs)
+{
+	// Find every place where scrubbing changes something, without decoding anything else.
+	//  Just like Scrub_ary, we skip over bytes that do not trigger any pass, and
+	//  run the cursor phases from each trigger until they have nothing queued up.
+
+	Splice_map_t map = {};
+	map.span = span;
+	map.arena_r = arena_r;
+
+	Scrub_scan_t scan = Scan_for_scrub(kernels_r, span, trigraphs);
+
+	Cursor_t cursor = Start_cursor(arena_r, span);
+	cursor.skip_phase[Phase_carriage_returns] = !scan.has_carriage_returns;
+	cursor.skip_phase[Phase_trigraphs] = !scan.has_trigraphs;
+	cursor.skip_phase[Phase_escaped_line_breaks] = !scan.has_escaped_line_breaks;
+
+	map.off_first = cursor.off_first;
+
+	uint32_t span_len = (uint32_t)Byte_span_len(span);
+	uint32_t off = cursor.off_first;
+	if (scan.off_first > off)
+	{
+		off = (uint32_t)scan.off_first;
+	}
+
+	Phase_k phase_last = (Phase_k)(Phase_max - 1);
+	Ch_queue_t * window_r = &cursor.queues[phase_last];
+
+	while (off < span_len)
+	{
+		// Fast path, skip bytes no pass cares about
+
+		Byte_span_t span_rest = {span.begin + off, span.end};
+		off += (uint32_t)Len_leading_non_trigger(kernels_r, span_rest, scan);
+		if (off == span_len)
+			break;
+
+		// Slow path, pull final chs through the phases until they are empty again,
+		//  and remember any ch that does not match what is in the raw bytes
+
+		Seek_cursor(&cursor, 0, off);
+
+		bool at_end = false;
+		while (true)
+		{
+			char32_t ch = Peek_phase_ch(&cursor, phase_last, 0);
+			uint32_t off_ch = window_r->offs[Queue_slot(window_r, window_r->i_begin)];
+
+			// Bytes that did not end up in any ch (dropped trailing escaped line break)
+
+			if (off_ch > off)
+			{
+				Push_splice(&map, off, off_ch, Mch_end);
+				off = off_ch;
+			}
+
+			if (ch == Mch_end)
+			{
+				at_end = true;
+				break;
+			}
+
+			Pop_queue(window_r, 1);
+
+			// Find where this ch ends. If nothing is queued up,
+			//  that is wherever decode got to, otherwise it is where the next ch starts
+
+			uint32_t off_end;
+			if (Are_phases_empty(&cursor))
+			{
+				off_end = (uint32_t)(cursor.span.begin - span.begin);
+			}
+			else
+			{
+				Peek_phase_ch(&cursor, phase_last, 0);
+				off_end = window_r->offs[Queue_slot(window_r, window_r->i_begin)];
+			}
+
+			Byte_span_t span_ch = {span.begin + off_ch, span.end};
+			Ch_len_t ch_len = Decode_leading_ch(span_ch);
+			if (ch_len.ch != ch || off_ch + ch_len.len != off_end)
+			{
+				Push_splice(&map, off_ch, off_end, ch);
+			}
+
+			off = off_end;
+
+			if (Are_phases_empty(&cursor))
+				break;
+		}
+
+		if (at_end)
+			break;
+	}
+
+	// Sentinel
+
+	Push_splice(&map, UINT32_MAX, UINT32_MAX, Mch_end);
+
+	return map;
+}
+
+size_t Find_splice(
+	Splice_map_t * map_r,
+	uint32_t off)
+{
+	// Index of the first splice that ends after off, by binary search
+
+	size_t i_lo = 0;
+	size_t i_hi = map_r->len - 1; // the sentinel always qualifies
+	while (i_lo < i_hi)
+	{
+		size_t i_mid = i_lo + (i_hi - i_lo) / 2;
+		if (map_r->splices[i_mid].off_end <= off)
+		{
+			i_lo = i_mid + 1;
+		}
+		else
+		{
+			i_hi = i_mid;
+		}
+	}
+
+	return i_lo;
+}
+
+typedef struct Splice_it_t
+{
+	// Lets the lexer walk the raw bytes of a splice_map, as if they were scrubbed chs.
+	//  off is always the loc of the ch we are on, so mapping back to the source
+	//  is free, and i_splice is the next splice at or after off.
+
+	Splice_map_t * map_r;
+	uint32_t off;
+	size_t i_splice;
+
+	void Skip_empty_splices()
+	{
+		// Splices that scrub down to nothing are not chs, so never stop on them
+
+		Splice_t * splice_r = &map_r->splices[i_splice];
+		while (splice_r->off_begin == off && splice_r->ch == Mch_end)
+		{
+			off = splice_r->off_end;
+			++i_splice;
+			++splice_r;
+		}
+	}
+
+	char32_t operator*() const
+	{
+		Splice_t * splice_r = &map_r->splices[i_splice];
+		if (splice_r->off_begin == off)
+			return splice_r->ch;
+
+		Byte_span_t span = {map_r->span.begin + off, map_r->span.end};
+		if (span.begin == span.end)
+			return Mch_end;
+
+		if (span.begin[0] < 0x80)
+			return span.begin[0];
+
+		return Decode_leading_ch(span).ch;
+	}
+
+	char32_t operator[](size_t i) const
+	{
+		return *(*this + i);
+	}
+
+	Splice_it_t & operator++()
+	{
+		Splice_t * splice_r = &map_r->splices[i_splice];
+		if (splice_r->off_begin == off)
+		{
+			off = splice_r->off_end;
+			++i_splice;
+		}
+		else
+		{
+			Byte_span_t span = {map_r->span.begin + off, map_r->span.end};
+			if (span.begin == span.end)
+				return *this;
+
+			if (span.begin[0] < 0x80)
+			{
+				off += 1;
+			}
+			else
+			{
+				off += (uint32_t)Decode_leading_ch(span).len;
+			}
+		}
+
+		Skip_empty_splices();
+		return *this;
+	}
+
+	Splice_it_t & operator+=(size_t len)
+	{
+		for (size_t i = 0; i < len; ++i)
+		{
+			++*this;
+		}
+
+		return *this;
+	}
+
+	Splice_it_t operator+(size_t len) const
+	{
+		Splice_it_t result = *this;
+		result += len;
+		return result;
+	}
+} Splice_it_t;
+
+Splice_it_t Start_splice_it(
+	Splice_map_t * map_r,
+	uint32_t off)
+{
+	// off must be the loc of a ch
+
+	Splice_it_t it = {map_r, off, Find_splice(map_r, off)};
+	it.Skip_empty_splices();
+	return it;
+}
+
+Byte_span_t Raw_span_from_it(Splice_it_t it)
+{
+	Byte_span_t span = {it.map_r->span.begin + it.off, it.map_r->span.end};
+	return span;
+}
+
+const Lex_env_t * Env_from_it(Splice_it_t it)
+{
+	return it.map_r->env_r;
+}
+
+Splice_it_t Seek_raw_loc(
+	Splice_it_t it,
+	Byte_t * loc)
+{
+	return Start_splice_it(it.map_r, (uint32_t)(loc - it.map_r->span.begin));
+}
+
+
+
+// 'ary it' : walk a Ch_loc_ary_t. Just a char32_t *, plus the ary,
+//  so we can get back to the raw bytes under each ch
+
+typedef struct Ary_it_t
+{
+	char32_t * it;
+	const Ch_loc_ary_t * ary_r;
+
+	char32_t operator*() const
+	{
+		return *it;
+	}
+
+	char32_t operator[](size_t i) const
+	{
+		return it[i];
+	}
+
+	Ary_it_t & operator++()
+	{
+		++it;
+		return *this;
+	}
+
+	Ary_it_t & operator+=(size_t len)
+	{
+		it += len;
+		return *this;
+	}
+
+	Ary_it_t operator+(size_t len) const
+	{
+		Ary_it_t result = {it + len, ary_r};
+		return result;
+	}
+} Ary_it_t;
+
+Byte_span_t Raw_span_from_it(Ary_it_t it)
+{
+	const Ch_loc_ary_t * ary_r = it.ary_r;
+	Byte_span_t span = {ary_r->span.begin + ary_r->offs[it.it - ary_r->chs], ary_r->span.end};
+	return span;
+}
+
+const Lex_env_t * Env_from_it(Ary_it_t it)
+{
+	return it.ary_r->env_r;
+}
+
+Ary_it_t Seek_raw_loc(
+	Ary_it_t it,
+	Byte_t * loc)
+{
+	// First ch at or after loc, by binary search (offs only go up)
+
+	const Ch_loc_ary_t * ary_r = it.ary_r;
+	uint32_t off = (uint32_t)(loc - ary_r->span.begin);
+
+	size_t i_lo = (size_t)(it.it - ary_r->chs);
+	size_t i_hi = ary_r->len; // Mch_end always qualifies
+	while (i_lo < i_hi)
+	{
+		size_t i_mid = i_lo + (i_hi - i_lo) / 2;
+		if (ary_r->offs[i_mid] < off)
+		{
+			i_lo = i_mid + 1;
+		}
+		else
+		{
+			i_hi = i_mid;
+		}
+	}
+
+	it.it = ary_r->chs + i_lo;
+	return it;
+}
+
+
+
+// 'byte it' : lex raw bytes directly, for bytes we know are all ascii and
+//  have nothing to scrub (so each byte is exactly one ch, at its own loc)
+
+typedef struct Byte_it_ctx_t
+{
+	// What every Byte_it_t in one lex shares. Kept behind a pointer,
+	//  so a Byte_it_t stays small enough to pass around cheaply
+
+	const Lex_env_t * env_r;
+	bool hit_end;
+} Byte_it_ctx_t;
+
+typedef struct Byte_it_t
+{
+	// Reading at or past end gives Mch_end, and also sets ctx_r->hit_end,
+	//  so callers can tell if a token depended on what comes after end
+	//  (when end is not the end of the whole span)
+
+	Byte_t * it;
+	Byte_t * end;
+	Byte_it_ctx_t * ctx_r;
+
+	char32_t operator*() const
+	{
+		return (*this)[0];
+	}
+
+	char32_t operator[](size_t i) const
+	{
+		if (i < (size_t)(end - it))
+			return it[i];
+
+		ctx_r->hit_end = true;
+		return Mch_end;
+	}
+
+	Byte_it_t & operator++()
+	{
+		if (it < end)
+		{
+			++it;
+		}
+
+		return *this;
+	}
+
+	Byte_it_t & operator+=(size_t len)
+	{
+		size_t len_max = (size_t)(end - it);
+		it += (len < len_max) ? len : len_max;
+		return *this;
+	}
+
+	Byte_it_t operator+(size_t len) const
+	{
+		Byte_it_t result = *this;
+		result += len;
+		return result;
+	}
+} Byte_it_t;
+
+Byte_span_t Raw_span_from_it(Byte_it_t it)
+{
+	// NOTE this stops at end, not at the end of the whole span
+
+	Byte_span_t span = {it.it, it.end};
+	return span;
+}
+
+const Lex_env_t * Env_from_it(Byte_it_t it)
+{
+	return it.ctx_r->env_r;
+}
+
+Byte_it_t Seek_raw_loc(
+	Byte_it_t it,
+	Byte_t * loc)
+{
+	it.it = loc;
+	return it;
+}
+
+size_t Len_leading_clean(
+	const Kernels_t * kernels_r,
+	Byte_span_t span,
+	Scrub_scan_t scan)
+{
+	// Count leading bytes that Byte_it_t can lex, that is,
+	//  ascii bytes before the first thing we would need to scrub
+
+	size_t span_len = Byte_span_len(span);
+	size_t len = Len_leading_ascii(kernels_r, span);
+
+	while (len < span_len && span.begin[len] < 0x80)
+	{
+		++len;
+	}
+
+	return (len < scan.off_first) ? len : scan.off_first;
+}
+
+
+
+// Lex
+
+// TODO TokkLen_t !!!!!!
+
+// Token kinds (Tokk_t) are in ctok.h
+
+const char * Str_from_tokk(Tokk_t tokk)
+{
+	static const char *  str_for_tokk[] =
+	{
+		#define X(id) #id,
+		TOKEN_KINDS()	
+		#undef X
+	};
+
+	const char * str = str_for_tokk[tokk];
+
+	// clang names keyword kinds by their spelling ("int", not "kw_int")
+
+	if (tokk >= Tokk_kw_auto && tokk <= Tokk_kw___unknown_anytype)
+	{
+		str += 3;
+	}
+
+	return str;
+}
+
+
+
+// Which code points start/extend ids. ascii is a bitmap (same for every table set),
+//  everything else goes through the two-stage tables in id_tables.h
+//  (see gen_id_tables.py): the top bits of a code point pick a 256 code point block,
+//  and each block is a 256 bit bitset, shared with any other block that has the same bits
+
+typedef struct Id_tables_t
+{
+	const uint64_t (* blocks)[4];
+	const uint8_t * i_block_start;
+	const uint8_t * i_block_continue;
+} Id_tables_t;
+
+static const Id_tables_t id_tables_c11 = {id_blocks_c11, id_start_c11, id_continue_c11};
+static const Id_tables_t id_tables_c23 = {id_blocks_c23, id_start_c23, id_continue_c23};
+
+bool Is_ch_in_id_table(
+	const Id_tables_t * id_tables_r,
+	const uint8_t * i_block_from_block,
+	char32_t ch)
+{
+	// Bogus utf8 (and Mch_*) are not in any table
+
+	if (ch > 0x10FFFF)
+		return false;
+
+	const uint64_t * bits = id_tables_r->blocks[i_block_from_block[ch >> 8]];
+	return (bits[(ch >> 6) & 3] >> (ch & 63)) & 1;
+}
+
+// Letters, underscore, digits, and '$' (allowed as an extension :/ )
+
+static const uint64_t id_continue_ascii[2] = { 0x03FF001000000000, 0x07FFFFFE87FFFFFE };
+
+// Same, minus digits
+
+static const uint64_t id_start_ascii[2] = { 0x0000001000000000, 0x07FFFFFE87FFFFFE };
+
+bool Extends_id(
+	const Id_tables_t * id_tables_r,
+	char32_t ch)
+{
+	if (ch <= 0x7F)
+		return (id_continue_ascii[ch >> 6] >> (ch & 63)) & 1;
+
+	return Is_ch_in_id_table(id_tables_r, id_tables_r->i_block_continue, ch);
+}
+
+bool Starts_id(
+	const Id_tables_t * id_tables_r,
+	char32_t ch)
+{
+	if (ch <= 0x7F)
+		return (id_start_ascii[ch >> 6] >> (ch & 63)) & 1;
+
+	return Is_ch_in_id_table(id_tables_r, id_tables_r->i_block_start, ch);
+}
+
+
+
+// keywords : turn an id into a Tokk_kw_*, with a perfect hash (see gen_kw_table.py)
+
+typedef enum Kwd_k // keyword dialect
+{
+	Kwd_c89		= 1 << 0, // Every C
+	Kwd_c99		= 1 << 1, // No C11 bit, clang has no C11-only keywords (_Alignas and co. are in every C)
+	Kwd_c23		= 1 << 2,
+	Kwd_cxx		= 1 << 3, // Every C++
+	Kwd_cxx11	= 1 << 4,
+	Kwd_cxx20	= 1 << 5,
+	Kwd_gnu		= 1 << 6, // GNU keywords (asm, typeof, ...) in gnu modes
+	Kwd_ms		= 1 << 7,
+	Kwd_opencl	= 1 << 8,
+	Kwd_ext		= 1 << 9, // Other extensions we never turn on (altivec, CUDA, HLSL, ...)
+} Kwd_k;
+
+// Dialect masks for common languages. A spelling is a keyword
+//  if its dialects have any bit in common with the mask.
+
+static const uint32_t kwd_mask_c89 = Kwd_c89;
+static const uint32_t kwd_mask_c11 = Kwd_c89 | Kwd_c99;
+static const uint32_t kwd_mask_c23 = Kwd_c89 | Kwd_c99 | Kwd_c23;
+static const uint32_t kwd_mask_cxx17 = Kwd_cxx | Kwd_cxx11;
+static const uint32_t kwd_mask_cxx20 = Kwd_cxx | Kwd_cxx11 | Kwd_cxx20;
+
+typedef struct Kw_t
+{
+	const char * str;
+	uint32_t len;
+	uint32_t hash;
+	Tokk_t tokk;
+	uint32_t kwd_mask;
+} Kw_t;
+
+#include "kw_table.h"
+
+// env : the lexer's runtime knobs. Every It can get at one (see Env_from_it),
+//  so lexing never touches global state, and lexes with different knobs can run at once
+
+typedef struct Lex_env_t
+{
+	const Kernels_t * kernels_r;
+	const Id_tables_t * id_tables_r;
+
+	// Dialects to recognize keywords for, or 0 to leave ids raw (like clang -dump-raw-tokens)
+
+	uint32_t kwd_mask;
+} Lex_env_t;
+
+template <typename It>
+Tokk_t Tokk_from_id(
+	It it,
+	bool is_ascii)
+{
+	// Look up the id starting at it. is_ascii is false if lexing the id
+	//  ran into anything that is not in a keyword (non-ascii, ucns).
+
+	const Lex_env_t * env_r = Env_from_it(it);
+
+	if (!env_r->kwd_mask)
+		return Tokk_raw_identifier;
+
+	if (!is_ascii)
+		return Tokk_identifier;
+
+	// Hash (FNV-1a) the id, as long as it is short enough to be a keyword
+
+	char str[kw_len_max + 1];
+	uint32_t len = 0;
+	uint32_t hash = 2166136261u;
+
+	while (Extends_id(env_r->id_tables_r, *it))
+	{
+		if (len == kw_len_max)
+			return Tokk_identifier;
+
+		char32_t ch = *it;
+		str[len] = (char)ch;
+		hash = (hash ^ ch) * 16777619u;
+
+		++len;
+		++it;
+	}
+
+	uint32_t disp = kw_disps[hash & (kw_bucket_count - 1)];
+	uint32_t slot = ((hash ^ disp) * 0x9E3779B1u) >> (32 - kw_slot_bits);
+
+	uint32_t i_kw = kw_i_kw_from_slot[slot];
+	if (!i_kw)
+		return Tokk_identifier;
+
+	const Kw_t * kw_r = &kws[i_kw - 1];
+	if (kw_r->hash != hash || kw_r->len != len)
+		return Tokk_identifier;
+
+	if (!(kw_r->kwd_mask & env_r->kwd_mask))
+		return Tokk_identifier;
+
+	// Same hash and len, make sure it is actually the same spelling
+
+	if (memcmp(kw_r->str, str, len) != 0)
+		return Tokk_identifier;
+
+	return kw_r->tokk;
+}
+
+// lang : the parts of each language the lexer cares about. Each Lang_*_t is a
+//  set of compile time flags, and the lexer is instantiated once per Lang_*_t
+//  (see Lex_tokens), so whatever a language does not have compiles out.
+
+// Digraphs came in with C95 (so not C89), ucns and line comments with C99 (and C++98).
+//  Trigraphs are gone in C23 and C++17. is_cxx is raw strings, '.*', '->*',
+//  and the "<::" rule (all C++11). Digit separators are C++14 and C23, u8 char lits
+//  are C23 and C++17, and '<=>' is C++20.
+
+// NOTE '$' in ids and the '::' token are not here, since clang
+//  lexes both in every one of these languages
+
+// Lang_k (-std=) is in ctok.h
+
+struct Lang_c89_t
+{
+	static const bool has_line_comments = false;
+	static const bool has_trigraphs = true;
+	static const bool has_digraphs = false;
+	static const bool has_ucns = false;
+	static const bool has_utf8_char_lits = false;
+	static const bool is_cxx = false;
+	static const bool has_digit_separators = false;
+	static const bool has_spaceship = false;
+};
+
+struct Lang_c11_t
+{
+	static const bool has_line_comments = true;
+	static const bool has_trigraphs = true;
+	static const bool has_digraphs = true;
+	static const bool has_ucns = true;
+	static const bool has_utf8_char_lits = false;
+	static const bool is_cxx = false;
+	static const bool has_digit_separators = false;
+	static const bool has_spaceship = false;
+};
+
+struct Lang_c23_t
+{
+	static const bool has_line_comments = true;
+	static const bool has_trigraphs = false;
+	static const bool has_digraphs = true;
+	static const bool has_ucns = true;
+	static const bool has_utf8_char_lits = true;
+	static const bool is_cxx = false;
+	static const bool has_digit_separators = true;
+	static const bool has_spaceship = false;
+};
+
+struct Lang_cxx17_t
+{
+	static const bool has_line_comments = true;
+	static const bool has_trigraphs = false;
+	static const bool has_digraphs = true;
+	static const bool has_ucns = true;
+	static const bool has_utf8_char_lits = true;
+	static const bool is_cxx = true;
+	static const bool has_digit_separators = true;
+	static const bool has_spaceship = false;
+};
+
+struct Lang_cxx20_t
+{
+	static const bool has_line_comments = true;
+	static const bool has_trigraphs = false;
+	static const bool has_digraphs = true;
+	static const bool has_ucns = true;
+	static const bool has_utf8_char_lits = true;
+	static const bool is_cxx = true;
+	static const bool has_digit_separators = true;
+	static const bool has_spaceship = true;
+};
+
+const Id_tables_t * Id_tables_from_lang(Lang_k lang)
+{
+	// C23 and C++ ids are XID_Start/XID_Continue (clang does that for every C++).
+	//  C11 and C89 get C11 ids (close enough for C89)
+
+	switch (lang)
+	{
+	case Lang_c23:
+	case Lang_cxx17:
+	case Lang_cxx20:
+		return &id_tables_c23;
+
+	default:
+		return &id_tables_c11;
+	}
+}
+
+uint32_t Kwd_mask_from_lang(Lang_k lang)
+{
+	// NOTE C89 still gets _Bool and friends (clang has them in every C),
+	//  just not the C99 ones (restrict, inline)
+
+	switch (lang)
+	{
+	case Lang_c89: return kwd_mask_c89;
+	case Lang_c23: return kwd_mask_c23;
+	case Lang_cxx17: return kwd_mask_cxx17;
+	case Lang_cxx20: return kwd_mask_cxx20;
+	default: return kwd_mask_c11;
+	}
+}
+
+// The lexer is written against It, which is anything that can be walked like
+//  a char32_t * (*it, it[i], ++it, it += len, it + len), and ends with Mch_end.
+//  Right now that is an Ary_it_t, a Cursor_it_t, a Splice_it_t, or a Byte_it_t.
+//  Each also has Raw_span_from_it and Seek_raw_loc, for C++ raw strings.
+
+template <typename It>
+struct Tokk_end_t
+{
+	Tokk_t tokk;
+	It end;
+};
+
+template <typename It>
+Tokk_end_t<It> Make_tokk_end(Tokk_t tokk, It end)
+{
+	Tokk_end_t<It> result = {tokk, end};
+	return result;
+}
+
+// 'scan toward' : skip over runs of boring chs in bulk.
+//  The generic versions just step one ch at a time. Ary_it_t and Byte_it_t
+//  get overloads that go through the It's kernels (see 'simd' above), which may
+//  stop early at non-ascii chs, so callers always loop.
+
+template <typename It>
+It Scan_toward_chs(
+	It it,
+	char32_t ch_0,
+	char32_t ch_1,
+	char32_t ch_2)
+{
+	// Move toward the next ch_0/ch_1/ch_2 (or Mch_end). May stop early, see above
+
+	while (true)
+	{
+		char32_t ch = *it;
+		if (ch == ch_0 || ch == ch_1 || ch == ch_2 || ch == Mch_end)
+			break;
+
+		++it;
+	}
+
+	return it;
+}
+
+Ary_it_t Scan_toward_chs(
+	Ary_it_t it,
+	char32_t ch_0,
+	char32_t ch_1,
+	char32_t ch_2)
+{
+	assert(ch_0 < 0x80 && ch_1 < 0x80 && ch_2 < 0x80);
+
+	it.it = Env_from_it(it)->kernels_r->Scan_toward_chs_in_chs(it.it, (char)ch_0, (char)ch_1, (char)ch_2);
+	return it;
+}
+
+Byte_it_t Scan_toward_chs(
+	Byte_it_t it,
+	char32_t ch_0,
+	char32_t ch_1,
+	char32_t ch_2)
+{
+	assert(ch_0 < 0x80 && ch_1 < 0x80 && ch_2 < 0x80);
+
+	it.it = Env_from_it(it)->kernels_r->Scan_toward_chs_in_bytes(it.it, it.end, (char)ch_0, (char)ch_1, (char)ch_2);
+	return it;
+}
+
+template <typename It>
+It Scan_toward_ch(
+	It it,
+	char32_t ch)
+{
+	return Scan_toward_chs(it, ch, ch, ch);
+}
+
+template <typename It>
+It Scan_past_ws(It it)
+{
+	// Move past any whitespace. Unlike the other scans, this never stops early
+
+	while (Is_ws(*it))
+	{
+		++it;
+	}
+
+	return it;
+}
+
+Ary_it_t Scan_past_ws(Ary_it_t it)
+{
+	it.it = Env_from_it(it)->kernels_r->Scan_past_ws_in_chs(it.it);
+	return it;
+}
+
+Byte_it_t Scan_past_ws(Byte_it_t it)
+{
+	it.it = Env_from_it(it)->kernels_r->Scan_past_ws_in_bytes(it.it, it.end);
+	return it;
+}
+
+template <typename It>
+It Scan_past_id_run(It it)
+{
+	// Move past any ascii chs that extend ids. Stops at anything else,
+	//  callers deal with ucns and non-ascii chs
+
+	while (*it < 0x80 && (Is_ascii_alnum(*it) || *it == '$'))
+	{
+		++it;
+	}
+
+	return it;
+}
+
+Ary_it_t Scan_past_id_run(Ary_it_t it)
+{
+	it.it = Env_from_it(it)->kernels_r->Scan_past_id_run_in_chs(it.it);
+	return it;
+}
+
+Byte_it_t Scan_past_id_run(Byte_it_t it)
+{
+	it.it = Env_from_it(it)->kernels_r->Scan_past_id_run_in_bytes(it.it, it.end);
+	return it;
+}
+
+template <typename It>
+It Scan_past_ppnum_run(It it)
+{
+	// Move past any ascii chs that extend ppnums, including [eEpP][+-].
+	//  Stops at anything else, callers deal with ucns and non-ascii chs.
+
+	// NOTE the ch before it is never an exponent, since callers only 
+	//  start us after a digit, '.', ucn or non-ascii ch
+
+	while (true)
+	{
+		char32_t ch = *it;
+		if (ch == '.' || (ch < 0x80 && Is_ascii_alnum(ch)))
+		{
+			++it;
+
+			if (Is_exponent_sign(ch, *it))
+			{
+				++it;
+			}
+
+			continue;
+		}
+
+		break;
+	}
+
+	return it;
+}
+
+Ary_it_t Scan_past_ppnum_run(Ary_it_t it)
+{
+	it.it = Env_from_it(it)->kernels_r->Scan_past_ppnum_run_in_chs(it.it);
+	return it;
+}
+
+Byte_it_t Scan_past_ppnum_run(Byte_it_t it)
+{
+	it.it = Env_from_it(it)->kernels_r->Scan_past_ppnum_run_in_bytes(it.it, it.end);
+	return it;
+}
+
+template <typename Lang, typename It>
+Tokk_end_t<It> Lex_punctuation(
+	It it)
+{
+	// Maximal munch, switching on each ch in turn,
+	//  so we only ever look at the chs that could extend the punctuation
+
+	// "::" is included to match clang
+	// https://github.com/llvm/llvm-project/commit/874217f99b99ab3c9026dc3b7bd84cd2beebde6e
+
+	// NOTE digraphs (<: :> <% %> %: %:%:) are their own tokk in clang,
+	//  just spelled differently, so we return the tokk they stand for.
+	//  Without digraphs (C89), they are just their first ch
+
+	char32_t ch_0 = *it;
+	switch (ch_0)
+	{
+	case '~': return Make_tokk_end(Tokk_tilde, it + 1);
+	case '}': return Make_tokk_end(Tokk_r_brace, it + 1);
+	case '{': return Make_tokk_end(Tokk_l_brace, it + 1);
+	case ']': return Make_tokk_end(Tokk_r_square, it + 1);
+	case '[': return Make_tokk_end(Tokk_l_square, it + 1);
+	case '?': return Make_tokk_end(Tokk_question, it + 1);
+	case ';': return Make_tokk_end(Tokk_semi, it + 1);
+	case ',': return Make_tokk_end(Tokk_comma, it + 1);
+	case ')': return Make_tokk_end(Tokk_r_paren, it + 1);
+	case '(': return Make_tokk_end(Tokk_l_paren, it + 1);
+
+	default:
+		break;
+	}
+
+	char32_t ch_1 = it[1];
+	switch (ch_0)
+	{
+	case '%':
+		switch (ch_1)
+		{
+		case ':':
+			if (!Lang::has_digraphs)
+				return Make_tokk_end(Tokk_percent, it + 1);
+
+			if (it[2] == '%' && it[3] == ':')
+				return Make_tokk_end(Tokk_hashhash, it + 4);
+
+			return Make_tokk_end(Tokk_hash, it + 2);
+
+		case '>':
+			if (!Lang::has_digraphs)
+				return Make_tokk_end(Tokk_percent, it + 1);
+
+			return Make_tokk_end(Tokk_r_brace, it + 2);
+
+		case '=': return Make_tokk_end(Tokk_percentequal, it + 2);
+		default: return Make_tokk_end(Tokk_percent, it + 1);
+		}
+
+	case '>':
+		switch (ch_1)
+		{
+		case '>':
+			if (it[2] == '=')
+				return Make_tokk_end(Tokk_greatergreaterequal, it + 3);
+
+			return Make_tokk_end(Tokk_greatergreater, it + 2);
+
+		case '=': return Make_tokk_end(Tokk_greaterequal, it + 2);
+		default: return Make_tokk_end(Tokk_greater, it + 1);
+		}
+
+	case '<':
+		switch (ch_1)
+		{
+		case '<':
+			if (it[2] == '=')
+				return Make_tokk_end(Tokk_lesslessequal, it + 3);
+
+			return Make_tokk_end(Tokk_lessless, it + 2);
+
+		case '=':
+			if (Lang::has_spaceship && it[2] == '>')
+				return Make_tokk_end(Tokk_spaceship, it + 3);
+
+			return Make_tokk_end(Tokk_lessequal, it + 2);
+
+		case ':':
+			if (!Lang::has_digraphs)
+				return Make_tokk_end(Tokk_less, it + 1);
+
+			// C++11 [lex.pptoken]p3 : "<::" is '<' then "::",
+			//  unless the next ch is ':' or '>'
+
+			if (Lang::is_cxx && it[2] == ':' && it[3] != ':' && it[3] != '>')
+				return Make_tokk_end(Tokk_less, it + 1);
+
+			return Make_tokk_end(Tokk_l_square, it + 2);
+
+		case '%':
+			if (!Lang::has_digraphs)
+				return Make_tokk_end(Tokk_less, it + 1);
+
+			return Make_tokk_end(Tokk_l_brace, it + 2);
+
+		default: return Make_tokk_end(Tokk_less, it + 1);
+		}
+
+	case '.':
+		if (Lang::is_cxx && ch_1 == '*')
+			return Make_tokk_end(Tokk_periodstar, it + 2);
+
+		if (ch_1 == '.' && it[2] == '.')
+			return Make_tokk_end(Tokk_ellipsis, it + 3);
+
+		return Make_tokk_end(Tokk_period, it + 1);
+
+	case '|':
+		switch (ch_1)
+		{
+		case '=': return Make_tokk_end(Tokk_pipeequal, it + 2);
+		case '|': return Make_tokk_end(Tokk_pipepipe, it + 2);
+		default: return Make_tokk_end(Tokk_pipe, it + 1);
+		}
+
+	case '^':
+		if (ch_1 == '=')
+			return Make_tokk_end(Tokk_caretequal, it + 2);
+
+		return Make_tokk_end(Tokk_caret, it + 1);
+
+	case '=':
+		if (ch_1 == '=')
+			return Make_tokk_end(Tokk_equalequal, it + 2);
+
+		return Make_tokk_end(Tokk_equal, it + 1);
+
+	case ':':
+		switch (ch_1)
+		{
+		case ':': return Make_tokk_end(Tokk_coloncolon, it + 2);
+
+		case '>':
+			if (!Lang::has_digraphs)
+				return Make_tokk_end(Tokk_colon, it + 1);
+
+			return Make_tokk_end(Tokk_r_square, it + 2);
+
+		default: return Make_tokk_end(Tokk_colon, it + 1);
+		}
+
+	case '-':
+		switch (ch_1)
+		{
+		case '=': return Make_tokk_end(Tokk_minusequal, it + 2);
+		case '-': return Make_tokk_end(Tokk_minusminus, it + 2);
+		case '>':
+			if (Lang::is_cxx && it[2] == '*')
+				return Make_tokk_end(Tokk_arrowstar, it + 3);
+
+			return Make_tokk_end(Tokk_arrow, it + 2);
+
+		default: return Make_tokk_end(Tokk_minus, it + 1);
+		}
+
+	case '+':
+		switch (ch_1)
+		{
+		case '=': return Make_tokk_end(Tokk_plusequal, it + 2);
+		case '+': return Make_tokk_end(Tokk_plusplus, it + 2);
+		default: return Make_tokk_end(Tokk_plus, it + 1);
+		}
+
+	case '*':
+		if (ch_1 == '=')
+			return Make_tokk_end(Tokk_starequal, it + 2);
+
+		return Make_tokk_end(Tokk_star, it + 1);
+
+	case '&':
+		switch (ch_1)
+		{
+		case '=': return Make_tokk_end(Tokk_ampequal, it + 2);
+		case '&': return Make_tokk_end(Tokk_ampamp, it + 2);
+		default: return Make_tokk_end(Tokk_amp, it + 1);
+		}
+
+	case '#':
+		if (ch_1 == '#')
+			return Make_tokk_end(Tokk_hashhash, it + 2);
+
+		return Make_tokk_end(Tokk_hash, it + 1);
+
+	case '!':
+		if (ch_1 == '=')
+			return Make_tokk_end(Tokk_exclaimequal, it + 2);
+
+		return Make_tokk_end(Tokk_exclaim, it + 1);
+
+	case '/':
+		if (ch_1 == '=')
+			return Make_tokk_end(Tokk_slashequal, it + 2);
+
+		return Make_tokk_end(Tokk_slash, it + 1);
+
+	default:
+		break;
+	}
+
+	// Just return leading char as an unknown token
+
+	return Make_tokk_end(Tokk_unknown, it + 1);
+}
+
+bool Is_valid_ucn(char32_t ch)
+{
+	// A universal character name shall not specify a character whose
+	//  short identifier is less than 00A0, nor one in the range 
+	//  D800 through DFFF inclusive.
+
+	// BUG cite location in standard this working appears
+
+	if (ch < 0xA0)
+		return false;
+
+	if (ch >= 0xD800 && ch <= 0xDFFF)
+		return false;
+
+	return true;
+}
+
+uint32_t Hex_val_from_ch(char32_t ch)
+{
+	if (ch >= '0' && ch <= '9')
+		return ch - '0';
+
+	if (ch >= 'A' && ch <= 'F')
+		return ch - 'A' + 10;
+
+	if (ch >= 'a' && ch <= 'f')
+		return ch - 'a' + 10;
+
+	return Mch_invalid;
+}
+
+template <typename It>
+struct Ch_end_t
+{
+	char32_t ch;
+	It end;
+	bool has_end; // false if we did not find a ch at all (end is meaningless)
+};
+
+template <typename It>
+Ch_end_t<It> Make_ch_end(char32_t ch, It end)
+{
+	Ch_end_t<It> result = {ch, end, true};
+	return result;
+}
+
+template <typename It>
+Ch_end_t<It> Lex_ucn(
+	It it)
+{
+	Ch_end_t<It> invalid = {Mch_invalid, it, false};
+
+	// Leading '\\'
+
+	if (*it != '\\')
+		return invalid;
+
+	++it;
+
+	// U\u
+
+	if (*it != 'u' && *it != 'U')
+		return invalid;
+
+	int digits_need;
+	if (*it == 'u')
+	{
+		digits_need = 4;
+	}
+	else
+	{
+		digits_need = 8;
+	}
+
+	++it;
+
+	// String of hex digits, possibly between {}
+
+	char32_t result = 0;
+	int digits_read = 0;
+	bool delimited = false;
+	bool got_end_delim = false;
+
+	while (digits_read < digits_need || delimited)
+	{
+		// Handle {}
+
+		if (!delimited && digits_read == 0 && *it == '{')
+		{
+			delimited = true;
+			++it;
+			
+			continue;
+		}
+
+		if (delimited && *it == '}')
+		{
+			got_end_delim = true;
+			++it;
+			
+			break;
+		}
+
+		// Check if valid hex digit
+
+		char32_t val = Hex_val_from_ch(*it);
+		if (val == Mch_invalid)
+		{
+			if (delimited)
+				return invalid;
+
+			break;
+		}
+
+		// Avoid overflow
+
+		if (result & 0xF000'0000)
+			return invalid;
+
+		// Single hex digit
+
+		result <<= 4;
+		result |= val;
+
+		++digits_read;
+
+		++it;
+	}
+
+	// Error checks
+
+	if (digits_read == 0)
+		return invalid;
+
+	if (!delimited && digits_read != digits_need)
+		return invalid;
+
+	// Note that we still return a valid end if !Is_valid_ucn.
+	//  This lets us tell the difference between a syntactically invalid
+	//  ucn, and a 'semanticaly' invalid one.
+
+	if (!Is_valid_ucn(result))
+	{
+		result = Mch_invalid;
+	}
+
+	return Make_ch_end(result, it);
+}
+
+template <typename Lang, typename It>
+It After_rest_of_id(
+	It it,
+	bool * is_ascii_r)
+{
+	while (true)
+	{
+		// Skip ascii in bulk
+
+		it = Scan_past_id_run(it);
+
+		char32_t ch = *it;
+		if (Lang::has_ucns && ch == '\\')
+		{
+			// Yes, the standard says you can have ucn's in identifers :/ ...
+
+			Ch_end_t<It> ucn = Lex_ucn(it);
+			if (ucn.has_end && Extends_id(Env_from_it(it)->id_tables_r, ucn.ch))
+			{
+				*is_ascii_r = false;
+				it = ucn.end;
+				continue;
+			}
+
+			break;
+		}
+
+		if (ch >= 0x80 && Extends_id(Env_from_it(it)->id_tables_r, ch))
+		{
+			*is_ascii_r = false;
+			++it;
+			continue;
+		}
+
+		break;
+	}
+
+	return it;
+}
+
+template <typename Lang, typename It>
+It After_rest_of_ppnum(It it)
+{
+	/* NOTE (matthewd)
+		preprocesor numbers are a bit unintuitive,
+		since they can match things that are not valid tokens
+		in later translation phases.
 
 		so, here is a quick antlr style definition of pp-num
 
-		pp_num
-			: pp_num_start pp_num_continue*
-			;
+		pp_num
+			: pp_num_start pp_num_continue*
+			;
+
+		pp_num_start
+			: [0-9]
+			| '.' [0-9]
+			;
+
+		pp_num_continue
+			: '.'
+			| [eEpP][+-]
+			| [0-9a-zA-Z_]
+			;
+
+		also note that, this is not how this is defined in the standard.
+		That standard defines it with left recursion, so I factored out
+		the left recursion so it would be more obvious what the code was doing
+
+		the original definition is
+
+		pp_num
+			: [0-9]
+			| '.' [0-9]
+			| pp_num [0-9]
+			| pp_num identifier_nondigit
+			| pp_num 'e' [+-]
+			| pp_num 'E' [+-]
+			| pp_num 'p' [+-]
+			| pp_num 'P' [+-]
+			| pp_num '.'
+			;
+	*/
+
+	// Len_rest_of_pp_num is called after we see ( '.'? [0-9] ), that is, pp_num_start
+	// 'rest_of_pp_num' is equivalent to pp_num_continue*
+
+	while (true)
+	{
+		// '.', [eEpP][+-], and ascii that extends ids, in bulk.
+		//  Clang does not allow '$' in ppnums, even though the spec would seem
+		//  to suggest that implementation defined id chars should be included in PP nums...
+
+		it = Scan_past_ppnum_run(it);
+
+		char32_t ch = *it;
+
+		// Digit separator, if it is followed by something that extends ids (minus '$').
+		//  Like clang, we do not count an exponent right before one (1'e+2 is 1'e + 2)
+
+		if (Lang::has_digit_separators && ch == '\'' && Is_ascii_alnum(it[1]))
+		{
+			it += 2;
+			continue;
+		}
+
+		if (Lang::has_ucns && ch == '\\')
+		{
+			Ch_end_t<It> ucn = Lex_ucn(it);
+			if (ucn.has_end && Extends_id(Env_from_it(it)->id_tables_r, ucn.ch))
+			{
+				it = ucn.end;
+				continue;
+			}
+
+			break;
+		}
+
+		if (ch >= 0x80 && Extends_id(Env_from_it(it)->id_tables_r, ch))
+		{
+			// Everything (else) which extends ids can extend a ppnum
+
+			++it;
+			continue;
+		}
+
+		// Otherwise, no dice
+
+		break;
+	}
+
+	return it;
+}
+
+template <typename It>
+It After_rest_of_line_comment(It it)
+{
+	while (true)
+	{
+		it = Scan_toward_ch(it, '\n');
+
+		char32_t ch = *it;
+		if (ch == Mch_end || ch == '\n')
+			break;
+
+		++it;
+	}
+
+	return it;
+}
+
+template <typename It>
+Tokk_end_t<It> Lex_rest_of_block_comment(It it)
+{
+	Tokk_t tokk = Tokk_unknown;
+
+	while (true)
+	{
+		// Skip ahead to the next '*', in bulk if we can
+
+		it = Scan_toward_ch(it, '*');
+
+		char32_t ch = *it;
+		if (ch == Mch_end)
+			break;
+
+		++it;
+
+		if (ch == '*' && *it == '/')
+		{
+			tokk = Tokk_comment;
+			++it;
+			break;
+		}
+	}
+
+	return Make_tokk_end(tokk, it);
+}
+
+template <typename It>
+Tokk_end_t<It> Lex_rest_of_str_lit(
+	Tokk_t tokk,
+	It it)
+{
+	char32_t ch_close = U'"';
+	switch (tokk)
+	{
+	case Tokk_utf8_char_constant:
+	case Tokk_utf16_char_constant:
+	case Tokk_utf32_char_constant:
+	case Tokk_wide_char_constant:
+	case Tokk_char_constant:
+		ch_close = U'\'';
+		break;
+	}
+
+	// Zero length char lits are invalid
+
+	if (ch_close == '\'' && *it == '\'')
+		return Make_tokk_end(Tokk_unknown, it + 1);
+
+	while (true)
+	{
+		// Skip ahead to the next ch we care about, in bulk if we can
+
+		it = Scan_toward_chs(it, ch_close, '\\', '\n');
+
+		char32_t ch = *it;
+
+		// Reached end without seeing close quote
+
+		if (ch == Mch_end)
+			return Make_tokk_end(Tokk_unknown, it);
+
+		// Missing closing quote
+
+		if (ch == '\n')
+			return Make_tokk_end(Tokk_unknown, it);
+
+		// Include in string
+
+		++it;
+
+		// Check for close quote
+
+		if (ch == ch_close)
+			return Make_tokk_end(tokk, it);
+
+		// Deal with back slash (skip past next char, whatever it is)
+
+		// NOTE that we do not have to think about backslash escaped newlines here,
+		//  we already scrubbed them away
+
+		if (ch == '\\' && *it != Mch_end)
+		{
+			++it;
+		}
+	}
+}
+
+bool Is_raw_str_delim_byte(Byte_t byte)
+{
+	// Chs allowed in a raw string delimiter : the basic source chs, minus
+	//  space, '(', ')', '\\' and control chs (same as clang's isRawStringDelimBody)
+
+	if ((byte >= 'a' && byte <= 'z') ||
+		(byte >= 'A' && byte <= 'Z') ||
+		(byte >= '0' && byte <= '9'))
+	{
+		return true;
+	}
+
+	switch (byte)
+	{
+	case '_': case '.': case '{': case '}': case '[': case ']':
+	case '#': case '<': case '>': case '%': case ':': case ';':
+	case '?': case '*': case '+': case '-': case '/': case '^':
+	case '&': case '|': case '~': case '!': case '=': case ',':
+	case '"': case '\'':
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+template <typename It>
+Tokk_end_t<It> Lex_rest_of_raw_str_lit(
+	Tokk_t tokk,
+	It it)
+{
+	// it is on the opening '"' of R"delim( ... )delim".
+	//  Scrubbing is undone between the quotes (C++ [lex.pptoken]p3),
+	//  so we look at the raw bytes, then find our way back to an It
+
+	const Kernels_t * kernels_r = Env_from_it(it)->kernels_r;
+
+	Byte_span_t raw = Raw_span_from_it(it);
+
+	// The loc of the '"' may be the start of escaped line breaks before it
+
+	Byte_t * cur = raw.begin;
+	while (*cur != '"')
+	{
+		++cur;
+	}
+
+	++cur;
+
+	// Delimiter is up to 16 chs, then '('
+
+	size_t len_delim = 0;
+	while (len_delim < 16 &&
+		   cur + len_delim < raw.end &&
+		   Is_raw_str_delim_byte(cur[len_delim]))
+	{
+		++len_delim;
+	}
+
+	if (cur + len_delim == raw.end)
+	{
+		// NOTE look at Mch_end, so a Byte_it_t knows we needed what comes after raw.end
+
+		It end = Seek_raw_loc(it, raw.end);
+		(void)*end;
+
+		return Make_tokk_end(Tokk_unknown, end);
+	}
+
+	if (cur[len_delim] != '(')
+	{
+		// Bad delimiter. Same as clang, skip to the next '"' and call it all unknown
+
+		while (cur < raw.end)
+		{
+			Byte_t byte = *cur;
+			++cur;
+
+			if (byte == '"')
+				break;
+		}
+
+		return Make_tokk_end(Tokk_unknown, Seek_raw_loc(it, cur));
+	}
+
+	Byte_t * delim = cur;
+	cur += len_delim + 1;
+
+	// Look for ')' in bulk, then check for the delimiter and '"' after it
+
+	while (true)
+	{
+		cur = kernels_r->Scan_toward_chs_in_bytes(cur, raw.end, ')', ')', ')');
+
+		// Reached end without seeing the close
+
+		if (cur == raw.end)
+			return Make_tokk_end(Tokk_unknown, Seek_raw_loc(it, raw.end));
+
+		// The scan also stops at anything non-ascii
+
+		Byte_t byte = *cur;
+		++cur;
+
+		if (byte != ')')
+			continue;
+
+		if ((size_t)(raw.end - cur) > len_delim &&
+			memcmp(cur, delim, len_delim) == 0 &&
+			cur[len_delim] == '"')
+		{
+			return Make_tokk_end(tokk, Seek_raw_loc(it, cur + len_delim + 1));
+		}
+	}
+}
+
+template <typename It>
+It After_whitespace(It it)
+{
+	// NOTE the Byte_it_t version never reads past its end, but a run that gets there
+	//  ends right at the end, which Lex_clean_tokens already does not trust
+
+	return Scan_past_ws(it);
+}
+
+template <typename Lang, typename It>
+Tokk_end_t<It> Lex_rest_of_id(It it)
+{
+	// it is on a ch that starts an id
+
+	bool is_ascii = *it < 0x80;
+
+	It end = After_rest_of_id<Lang>(it + 1, &is_ascii);
+	return Make_tokk_end(Tokk_from_id(it, is_ascii), end);
+}
+
+typedef enum Lexc_k // Lex class, of the leading ch of a token
+{
+	Lexc_punct,		// Anything we do not know better about, see Lex_punctuation
+	Lexc_id,		// Starts an id
+	Lexc_id_prefix,	// Starts an id, or is a string/char lit prefix (u, U, L, R)
+	Lexc_digit,
+	Lexc_dot,		// Starts a ppnum, or is punctuation
+	Lexc_quote,
+	Lexc_slash,		// Starts a comment, or is punctuation
+	Lexc_ws,		// Also '\0', which clang lumps in with whitespace
+	Lexc_backslash,	// Starts a ucn, or is a stray backslash
+
+	Lexc_max
+} Lexc_k;
+
+template <typename Lang, typename It>
+Tokk_end_t<It> Lex_leading_token(It it)
+{
+	// Figure out what sort of token we have from the leading ch.
+	//  For ascii, that is a table lookup, so we can jump straight
+	//  to the right lexer. Anything else starts an id, or is punctuation.
+
+	#define P Lexc_punct
+	#define I Lexc_id
+	#define X Lexc_id_prefix
+	#define N Lexc_digit
+	#define W Lexc_ws
+	static const Byte_t lexc_from_ascii[128] =
+	{
+		// 00..1F : '\0', whitespace, other control chars
+
+		W, P, P, P, P, P, P, P, P, W, W, W, W, W, P, P,
+		P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, P,
+
+		// ' ' ! " # $ % & ' ( ) * + , - . /
+
+		W, P, Lexc_quote, P, I, P, P, Lexc_quote, P, P, P, P, P, P, Lexc_dot, Lexc_slash,
+
+		// 0..9 : ; < = > ?
+
+		N, N, N, N, N, N, N, N, N, N, P, P, P, P, P, P,
+
+		// @ A..O (L is a prefix)
+
+		P, I, I, I, I, I, I, I, I, I, I, I, X, I, I, I,
+
+		// P..Z [ \ ] ^ _ (R and U are prefixes)
+
+		I, I, X, I, I, X, I, I, I, I, I, P, Lexc_backslash, P, P, I,
+
+		// ` a..o
+
+		P, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I,
+
+		// p..z { | } ~ DEL (u is a prefix)
+
+		I, I, I, I, I, X, I, I, I, I, I, P, P, P, P, P,
+	};
+	#undef P
+	#undef I
+	#undef X
+	#undef N
+	#undef W
+
+	char32_t ch_0 = *it;
+
+	Lexc_k lexc;
+	if (ch_0 < 0x80)
+	{
+		lexc = (Lexc_k)lexc_from_ascii[ch_0];
+	}
+	else
+	{
+		lexc = Starts_id(Env_from_it(it)->id_tables_r, ch_0) ? Lexc_id : Lexc_punct;
+	}
+
+	switch (lexc)
+	{
+	case Lexc_id:
+		{
+			return Lex_rest_of_id<Lang>(it);
+		}
+
+	case Lexc_ws:
+		{
+			++it;
+			return Make_tokk_end(Tokk_unknown, After_whitespace(it));
+		}
+
+	case Lexc_digit:
+		{
+			++it;
+			return Make_tokk_end(Tokk_numeric_constant, After_rest_of_ppnum<Lang>(it));
+		}
+
+	case Lexc_id_prefix:
+		{
+			char32_t ch_1 = it[1];
+
+			// R is only a prefix for C++ raw strings (R"...", u8R"...", uR"...", UR"...", LR"...")
+
+			if (ch_0 == 'R')
+			{
+				if (Lang::is_cxx && ch_1 == '"')
+				{
+					it += 1;
+					return Lex_rest_of_raw_str_lit(Tokk_string_literal, it);
+				}
+
+				return Lex_rest_of_id<Lang>(it);
+			}
+
+			if (ch_0 == 'u' && ch_1 == '8')
+			{
+				char32_t ch_2 = it[2];
+
+				if (ch_2 == '"')
+				{
+					it += 3;
+					return Lex_rest_of_str_lit(Tokk_utf8_string_literal, it);
+				}
+
+				if (Lang::has_utf8_char_lits && ch_2 == '\'')
+				{
+					it += 3;
+					return Lex_rest_of_str_lit(Tokk_utf8_char_constant, it);
+				}
+
+				if (Lang::is_cxx && ch_2 == 'R' && it[3] == '"')
+				{
+					it += 3;
+					return Lex_rest_of_raw_str_lit(Tokk_utf8_string_literal, it);
+				}
+			}
+
+			if (Lang::is_cxx && ch_1 == 'R' && it[2] == '"')
+			{
+				it += 2;
+
+				Tokk_t tokk;
+				switch (ch_0)
+				{
+				case 'u': tokk = Tokk_utf16_string_literal; break;
+				case 'U': tokk = Tokk_utf32_string_literal; break;
+				default: tokk = Tokk_wide_string_literal; break; // 'L'
+				}
+
+				return Lex_rest_of_raw_str_lit(tokk, it);
+			}
+
+			if (ch_1 == '"' || ch_1 == '\'')
+			{
+				it += 2;
+
+				Tokk_t tokk;
+				switch (ch_0)
+				{
+				case 'u':
+					tokk = (ch_1 == '"') ? Tokk_utf16_string_literal : Tokk_utf16_char_constant;
+					break;
+				case 'U':
+					tokk = (ch_1 == '"') ? Tokk_utf32_string_literal : Tokk_utf32_char_constant;
+					break;
+				default: // 'L'
+					tokk = (ch_1 == '"') ? Tokk_wide_string_literal : Tokk_wide_char_constant;
+					break;
+				}
+
+				return Lex_rest_of_str_lit(tokk, it);
+			}
+
+			return Lex_rest_of_id<Lang>(it);
+		}
+
+	case Lexc_quote:
+		{
+			++it;
+
+			Tokk_t tokk = (ch_0 == '"') ? Tokk_string_literal : Tokk_char_constant;
+
+			return Lex_rest_of_str_lit(tokk, it);
+		}
+
+	case Lexc_slash:
+		{
+			char32_t ch_1 = it[1];
+
+			if (ch_1 == '*')
+			{
+				it += 2;
+				return Lex_rest_of_block_comment(it);
+			}
+
+			// Without line comments (C89), clang still lexes '//' as one, unless a '*'
+			//  comes next, so "a //**/ b" is still "a / b" like C89 says
+
+			if (ch_1 == '/' && (Lang::has_line_comments || it[2] != '*'))
+			{
+				it += 2;
+				return Make_tokk_end(Tokk_comment, After_rest_of_line_comment(it));
+			}
+
+			return Lex_punctuation<Lang>(it);
+		}
+
+	case Lexc_dot:
+		{
+			char32_t ch_1 = it[1];
+
+			if (ch_1 >= '0' && ch_1 <= '9')
+			{
+				it += 2;
+				return Make_tokk_end(Tokk_numeric_constant, After_rest_of_ppnum<Lang>(it));
+			}
+
+			return Lex_punctuation<Lang>(it);
+		}
+
+	case Lexc_backslash:
+		{
+			if (!Lang::has_ucns)
+			{
+				// No ucns (C89), so always a stray backslash
+
+				return Make_tokk_end(Tokk_unknown, it + 1);
+			}
+
+			Ch_end_t<It> ucn = Lex_ucn(it);
+			if (ucn.has_end)
+			{
+				if (Starts_id(Env_from_it(it)->id_tables_r, ucn.ch))
+				{
+					// ids with ucns are never keywords
+
+					bool is_ascii = false;
+
+					It end = After_rest_of_id<Lang>(ucn.end, &is_ascii);
+					return Make_tokk_end(Tokk_from_id(it, is_ascii), end);
+				}
+				else
+				{
+					// UCN that does not start an ID, return it as an unknown token
+
+					return Make_tokk_end(Tokk_unknown, ucn.end);
+				}
+			}
+			else
+			{
+				// Stray backslash, return as unknown token
+
+				return Make_tokk_end(Tokk_unknown, it + 1);
+			}
+		}
+
+	default: // Lexc_punct
+		return Lex_punctuation<Lang>(it);
+	}
+}
+
+
+
+// lexer : pull tokens one at a time, with a few tokens of lookahead.
+//  Built on a lazy cursor, so we only decode + scrub + lex as far as
+//  someone has asked, and a consumer that stops early only pays for what it read
+
+typedef struct Token_t
+{
+	Tokk_t tokk;
+	uint32_t off;	// relative to span.begin
+	uint32_t len;	// in bytes
+} Token_t;
+
+// Most lookahead Peek_token can do (a power of 2, since the ring is indexed with a mask)
+
+static const size_t lexer_ring_len = 8;
+
+template <typename Lang>
+struct Lexer_t
+{
+	Cursor_t cursor;
+	Cursor_it_t it;	// where the next token we lex starts
+
+	// Tokens we lexed ahead, but nobody has taken yet.
+	//  Indexed like Ch_queue_t, by how many tokens came before
+
+	Token_t ring[lexer_ring_len];
+	size_t i_begin;
+	size_t i_end;
+};
+
+template <typename Lang>
+void Start_lexer(
+	Lexer_t<Lang> * lexer_r,
+	const Lex_env_t * env_r,
+	Arena_t * arena_r,
+	Byte_span_t span)
+{
+	// NOTE lexer_r->it points at lexer_r->cursor, so do not copy a lexer once it is started.
+	//  Everything it needs comes out of arena_r, so there is nothing to free
+
+	lexer_r->cursor = Start_cursor(arena_r, span);
+	lexer_r->cursor.skip_phase[Phase_trigraphs] = !Lang::has_trigraphs;
+	lexer_r->cursor.env_r = env_r;
+
+	Cursor_it_t it = {&lexer_r->cursor, 0};
+	lexer_r->it = it;
+
+	lexer_r->i_begin = 0;
+	lexer_r->i_end = 0;
+}
+
+template <typename Lang>
+void Lex_into_ring(Lexer_t<Lang> * lexer_r)
+{
+	Cursor_t * cursor_r = &lexer_r->cursor;
+	Cursor_it_t it = lexer_r->it;
+
+	Token_t token;
+	if (*it == Mch_end)
+	{
+		// Once we run out, every token after is eof
+
+		token.tokk = Tokk_eof;
+		token.off = Cursor_off(cursor_r, it.i_ch);
+		token.len = 0;
+	}
+	else
+	{
+		Mark_cursor(cursor_r, it.i_ch);
+
+		uint32_t off_begin = Cursor_off(cursor_r, it.i_ch);
+
+		Tokk_end_t<Cursor_it_t> tokk_end = Lex_leading_token<Lang>(it);
+
+		uint32_t off_end = Cursor_off(cursor_r, tokk_end.end.i_ch);
+
+		token.tokk = tokk_end.tokk;
+		token.off = off_begin;
+		token.len = off_end - off_begin;
+
+		lexer_r->it = tokk_end.end;
+	}
+
+	lexer_r->ring[lexer_r->i_end & (lexer_ring_len - 1)] = token;
+	++lexer_r->i_end;
+}
+
+template <typename Lang>
+Token_t Peek_token(
+	Lexer_t<Lang> * lexer_r,
+	size_t i)
+{
+	// The token i tokens after the next one (Peek_token(lexer_r, 0) is the next one)
+
+	assert(i < lexer_ring_len);
+
+	while (lexer_r->i_end - lexer_r->i_begin <= i)
+	{
+		Lex_into_ring(lexer_r);
+	}
+
+	return lexer_r->ring[(lexer_r->i_begin + i) & (lexer_ring_len - 1)];
+}
+
+template <typename Lang>
+Token_t Next_token(Lexer_t<Lang> * lexer_r)
+{
+	Token_t token = Peek_token(lexer_r, 0);
+	++lexer_r->i_begin;
+	return token;
+}
+
+
+
+// line table : where each line starts, found in one pass over the raw bytes
+//  (Scan_line_starts), so line + col of a token is a lookup, not a walk over its bytes.
+//  Every reader (Print_token_buf, Token_visitor_t) goes through offs in order,
+//  so they step a Line_cursor_t forward instead of searching the table
+
+typedef struct Line_table_t
+{
+	uint32_t * offs;	// where each line starts, relative to span.begin. offs[0] is past any BOM
+	size_t len;
+} Line_table_t;
+
+Line_table_t Build_line_table(
+	const Kernels_t * kernels_r,
+	Arena_t * arena_r,
+	Byte_span_t span)
+{
+	// Guess a line per 32 bytes, and double cap if that was wrong.
+	//  The old offs just sit in the arena until it is reset
+
+	size_t span_len = Byte_span_len(span);
+	size_t cap = span_len / 32 + 64;
+	uint32_t * offs = (uint32_t *)Alloc_arena(arena_r, cap * sizeof(uint32_t));
+
+	// The first line starts after any UTF-8 BOM, same as the first token
+
+	uint32_t off_first = 0;
+	if (span_len >= 3 &&
+		span.begin[0] == 0xEF &&
+		span.begin[1] == 0xBB &&
+		span.begin[2] == 0xBF)
+	{
+		off_first = 3;
+	}
+
+	offs[0] = off_first;
+
+	uint32_t * offs_it = offs + 1;
+	Byte_t * it = span.begin + off_first;
+
+	while (true)
+	{
+		it = kernels_r->Scan_line_starts_in_bytes(it, span.end, span.begin, &offs_it, offs + cap);
+		if (it == span.end)
+			break;
+
+		size_t len = offs_it - offs;
+		uint32_t * offs_old = offs;
+
+		cap *= 2;
+		offs = (uint32_t *)Alloc_arena(arena_r, cap * sizeof(uint32_t));
+		memcpy(offs, offs_old, len * sizeof(uint32_t));
+
+		offs_it = offs + len;
+	}
+
+	Line_table_t table;
+	table.offs = offs;
+	table.len = offs_it - offs;
+
+	return table;
+}
+
+// Line_cursor_t : line + col for offs that never go backwards
 
-		pp_num_start
-			: [0-9]
-			| '.' [0-9]
-			;
+typedef struct Line_cursor_t
+{
+	const Line_table_t * table_r;
+	size_t i_line;
+} Line_cursor_t;
 
-		pp_num_continue
-			: '.'
-			| [eEpP][+-]
-			| [0-9a-zA-Z_]
-			;
+void Advance_line_cursor(
+	Line_cursor_t * cursor_r,
+	uint32_t off,
+	size_t * line_r,
+	size_t * col_r)
+{
+	const Line_table_t * table_r = cursor_r->table_r;
+	size_t i_line = cursor_r->i_line;
 
-		also note that, this is not how this is defined in the standard.
-		That standard defines it with left recursion, so I factored out
-		the left recursion so it would be more obvious what the code was doing
+	while (i_line + 1 < table_r->len && table_r->offs[i_line + 1] <= off)
+	{
+		++i_line;
+	}
 
-		the original definition is
+	cursor_r->i_line = i_line;
 
-		pp_num
-			: [0-9]
-			| '.' [0-9]
-			| pp_num [0-9]
-			| pp_num identifier_nondigit
-			| pp_num 'e' [+-]
-			| pp_num 'E' [+-]
-			| pp_num 'p' [+-]
-			| pp_num 'P' [+-]
-			| pp_num '.'
-			;
-	*/
+	*line_r = i_line + 1;
+	*col_r = off - table_r->offs[i_line] + 1;
+}
 
-	// Len_rest_of_pp_num is called after we see ( '.'? [0-9] ), that is, pp_num_start
-	// 'rest_of_pp_num' is equivalent to pp_num_continue*
+// col index : turns byte cols into code point or utf16 cols (see Col_unit_k).
+//  For each non-ascii ch that is not one unit per byte, we keep where it ends
+//  and how many more bytes than units its line has up to there, grouped by line.
+//  A col is then a binary search over the non-ascii chs before it on its line,
+//  and nothing at all on an ascii line.
+
+// NOTE we decode like the lexer does, so a bad byte is one code point (one utf16 unit)
+
+typedef struct Col_index_t
+{
+	Col_unit_k col_unit;
+
+	uint32_t * i_firsts;	// first entry of each line, and i_firsts[i_line + 1] is past its last. NULL for Col_unit_bytes
+	uint32_t * ends;		// off just past each non-ascii ch
+	uint32_t * deltas;		// bytes minus units, from the start of its line through this ch
+	size_t len;
+	size_t cap;
+
+	Arena_t * arena_r;
+} Col_index_t;
+
+void Alloc_col_arrays(
+	Col_index_t * index_r,
+	size_t cap)
+{
+	Arena_t * arena_r = index_r->arena_r;
+	index_r->ends = (uint32_t *)Alloc_arena(arena_r, cap * sizeof(uint32_t));
+	index_r->deltas = (uint32_t *)Alloc_arena(arena_r, cap * sizeof(uint32_t));
+	index_r->cap = cap;
+}
+
+void Push_col_entry(
+	Col_index_t * index_r,
+	uint32_t end,
+	uint32_t delta)
+{
+	if (index_r->len == index_r->cap)
+	{
+		// Double cap, same as Grow_token_buf
+
+		Col_index_t index_old = *index_r;
+		Alloc_col_arrays(index_r, index_old.cap * 2);
+
+		memcpy(index_r->ends, index_old.ends, index_old.len * sizeof(uint32_t));
+		memcpy(index_r->deltas, index_old.deltas, index_old.len * sizeof(uint32_t));
+	}
+
+	size_t i = index_r->len;
+	index_r->ends[i] = end;
+	index_r->deltas[i] = delta;
+
+	++index_r->len;
+}
+
+Col_index_t Build_col_index(
+	const Kernels_t * kernels_r,
+	Arena_t * arena_r,
+	Byte_span_t span,
+	const Line_table_t * lines_r,
+	Col_unit_k col_unit)
+{
+	Col_index_t index = {};
+	index.col_unit = col_unit;
+	index.arena_r = arena_r;
+
+	if (col_unit == Col_unit_bytes)
+		return index;
+
+	index.i_firsts = (uint32_t *)Alloc_arena(arena_r, (lines_r->len + 1) * sizeof(uint32_t));
+	index.i_firsts[0] = 0;
+	Alloc_col_arrays(&index, 64);
+
+	// Start where the first line does, to skip any BOM
+
+	size_t i_line = 0;
+	uint32_t delta = 0;
+	Byte_t * it = span.begin + lines_r->offs[0];
 
 	while (true)
 	{
-		if (it->ch == '.')
+		Byte_span_t span_rest = {it, span.end};
+		it += kernels_r->Len_leading_ascii(span_rest);
+		if (it == span.end)
+			break;
+
+		// Line breaks are ascii, so every line before this ch is done
+
+		uint32_t off = (uint32_t)(it - span.begin);
+		while (i_line + 1 < lines_r->len && lines_r->offs[i_line + 1] <= off)
 		{
-			++it;
-			continue;
+			++i_line;
+			index.i_firsts[i_line] = (uint32_t)index.len;
+			delta = 0;
 		}
-		else if (it->ch == 'e' || it->ch == 'E' || it->ch == 'p' || it->ch == 'P')
-		{
-			++it;
 
-			if (it->ch == '+' || it->ch == '-')
-			{
-				++it;
-			}
+		span_rest.begin = it;
+		Ch_len_t ch_len = Decode_leading_ch(span_rest);
+		it += ch_len.len;
 
-			continue;
-		}
-		else if (it->ch == '$')
+		size_t units = 1;
+		if (col_unit == Col_unit_utf16 && ch_len.ch >= 0x10000 && ch_len.ch < Mch_invalid)
 		{
-			// Clang does not allow '$' in ppnums, 
-			//  even though the spec would seem to suggest that 
-			//  implementation defined id chars should be included in PP nums...
-
-			break;
+			units = 2; // surrogate pair
 		}
-		else if (Extends_id(it->ch))
-		{
-			// Everything (else) which extends ids can extend a ppnum
 
-			++it;
-			continue;
+		if (ch_len.len != units)
+		{
+			delta += (uint32_t)(ch_len.len - units);
+			Push_col_entry(&index, (uint32_t)(it - span.begin), delta);
 		}
-		else if (it->ch == '\\')
+	}
+
+	for (++i_line; i_line <= lines_r->len; ++i_line)
+	{
+		index.i_firsts[i_line] = (uint32_t)index.len;
+	}
+
+	return index;
+}
+
+size_t Col_from_byte_col(
+	const Col_index_t * index_r,
+	size_t line,
+	uint32_t off,
+	size_t col)
+{
+	if (!index_r->i_firsts)
+		return col;
+
+	// Find the last non-ascii ch on this line that ends at or before off
+
+	size_t i_min = index_r->i_firsts[line - 1];
+	size_t i_max = index_r->i_firsts[line];
+
+	if (i_min == i_max || index_r->ends[i_min] > off)
+		return col;
+
+	while (i_max - i_min > 1)
+	{
+		size_t i_mid = i_min + (i_max - i_min) / 2;
+		if (index_r->ends[i_mid] <= off)
 		{
-			Ch_end_t ucn = Lex_ucn(it);
-			if (ucn.end && Extends_id(ucn.ch))
-			{
-				it = ucn.end;
-				continue;
-			}
-			else
-			{
-				break;
-			}
+			i_min = i_mid;
 		}
 		else
 		{
-			// Otherwise, no dice
-
-			break;
+			i_max = i_mid;
 		}
 	}
 
-	return it;
+	return col - index_r->deltas[i_min];
 }
 
-Ch_loc_t * After_rest_of_line_comment(Ch_loc_t * it)
+
+
+// token buf : the lexer's output. Tokens go in parallel arrays (kind, off, len),
+//  so lexing never allocates per token, and whoever wants the tokens
+//  (Print_token_buf, or anything else) walks the arrays afterwards.
+//  The arrays are in an arena, and go away when it is reset
+
+// NOTE offs are uint32_t, same as Ch_loc_ary_t, so spans are limited to 4GB
+
+typedef struct Token_buf_t
 {
-	while (it->ch != Mch_end)
-	{
-		if (it->ch == '\n')
-			break;
+	uint16_t * tokks;	// Tokk_t, narrowed to 16 bits
+	uint32_t * offs;	// where each token starts, relative to span.begin
+	uint32_t * lens;	// each token's len, in bytes
+	size_t len;
+	size_t cap;
 
-		++it;
-	}
+	Arena_t * arena_r;
+} Token_buf_t;
 
-	return it;
+void Alloc_token_arrays(
+	Token_buf_t * buf_r,
+	size_t cap)
+{
+	Arena_t * arena_r = buf_r->arena_r;
+	buf_r->tokks = (uint16_t *)Alloc_arena(arena_r, cap * sizeof(uint16_t));
+	buf_r->offs = (uint32_t *)Alloc_arena(arena_r, cap * sizeof(uint32_t));
+	buf_r->lens = (uint32_t *)Alloc_arena(arena_r, cap * sizeof(uint32_t));
+	buf_r->cap = cap;
 }
 
-Tokk_end_t Lex_rest_of_block_comment(Ch_loc_t * it)
+Token_buf_t Start_token_buf(
+	Arena_t * arena_r,
+	size_t span_len)
 {
-	Tokk_t tokk = Tokk_unknown;
+	// Guess about a token per 4 bytes, so most files never grow
 
-	while (it->ch != Mch_end)
-	{
-		char32_t ch = it->ch;
-		++it;
+	Token_buf_t buf = {};
+	buf.arena_r = arena_r;
+	Alloc_token_arrays(&buf, span_len / 4 + 16);
 
-		if (ch == '*' && it->ch == '/')
-		{
-			tokk = Tokk_comment;
-			++it;
-			break;
-		}
-	}
+	return buf;
+}
 
-	return Make_tokk_end(tokk, it);
+void Grow_token_buf(Token_buf_t * buf_r)
+{
+	// Double cap. The old arrays just sit in the arena until it is reset
+
+	Token_buf_t buf_old = *buf_r;
+	Alloc_token_arrays(buf_r, buf_old.cap * 2);
+
+	memcpy(buf_r->tokks, buf_old.tokks, buf_old.len * sizeof(uint16_t));
+	memcpy(buf_r->offs, buf_old.offs, buf_old.len * sizeof(uint32_t));
+	memcpy(buf_r->lens, buf_old.lens, buf_old.len * sizeof(uint32_t));
 }
 
-Tokk_end_t Lex_rest_of_str_lit(
+void Push_token(
+	Token_buf_t * buf_r,
 	Tokk_t tokk,
-	Ch_loc_t * it)
+	uint32_t off,
+	uint32_t len)
 {
-	char32_t ch_close = U'"';
-	switch (tokk)
+	if (buf_r->len == buf_r->cap)
 	{
-	case Tokk_utf16_char_constant:
-	case Tokk_utf32_char_constant:
-	case Tokk_wide_char_constant:
-	case Tokk_char_constant:
-		ch_close = U'\'';
-		break;
+		Grow_token_buf(buf_r);
 	}
 
-	int len = 0;
-	while (it->ch != Mch_end)
-	{
-		char32_t ch = it->ch;
+	size_t i = buf_r->len;
+	buf_r->tokks[i] = (uint16_t)tokk;
+	buf_r->offs[i] = off;
+	buf_r->lens[i] = len;
 
-		// Missing closing quote
+	++buf_r->len;
+}
 
-		if (ch == '\n')
-			return Make_tokk_end(Tokk_unknown, it);
+// Visitor : hand each token straight to a Visit_token_t (see Lex_bytes),
+//  with its line + col, instead of keeping it
 
-		// Include in string
+typedef struct Token_visitor_t
+{
+	Visit_token_t visit;
+	void * user_r;
 
-		++it;
+	Line_cursor_t line_cursor;
+	const Col_index_t * cols_r;
+} Token_visitor_t;
 
-		// Check for close quote
+void Push_token(
+	Token_visitor_t * visitor_r,
+	Tokk_t tokk,
+	uint32_t off,
+	uint32_t len)
+{
+	size_t line;
+	size_t col;
+	Advance_line_cursor(&visitor_r->line_cursor, off, &line, &col);
+	col = Col_from_byte_col(visitor_r->cols_r, line, off, col);
+
+	visitor_r->visit(
+		visitor_r->user_r,
+		tokk,
+		off,
+		off + len,
+		(uint32_t)line,
+		(uint32_t)col);
+}
 
-		if (ch == ch_close)
-		{
-			if (ch_close == '\'' && len == 0)
-			{
-				// Zero length char lits are invalid
+// The Lex_*_tokens functions below push each token to a Sink, which is anything
+//  with a Push_token overload : a Token_buf_t, or a Token_visitor_t
 
-				return Make_tokk_end(Tokk_unknown, it);
-			}
-			else
-			{
-				return Make_tokk_end(tokk, it);
-			}
-		}
+template <typename Sink>
+void Push_token_locs(
+	Sink * sink_r,
+	Byte_span_t span,
+	Tokk_t tokk,
+	Byte_t * loc_begin,
+	Byte_t * loc_end)
+{
+	Push_token(
+		sink_r,
+		tokk,
+		(uint32_t)(loc_begin - span.begin),
+		(uint32_t)(loc_end - loc_begin));
+}
 
-		// Something other than close quote, include in string body
+template <typename Lang, typename Sink>
+Byte_t * Lex_clean_tokens(
+	const Lex_env_t * env_r,
+	Byte_span_t span,
+	size_t len_clean,
+	Sink * sink_r)
+{
+	// Lex tokens from the first len_clean bytes of span, using Byte_it_t.
+	//  Stops at the first token that needs to look past those bytes,
+	//  and returns where that token starts (or span.end, if we got through everything)
 
-		++len;
+	// NOTE a token that ends right at clean_end does not count either,
+	//  since scrubbing can stretch the end of a ch (dropped trailing escaped line breaks)
 
-		// Deal with back slash (skip past next char, whatever it is)
+	Byte_t * clean_end = span.begin + len_clean;
 
-		// NOTE that we do not have to think about backslash escaped newlines here,
-		//  we already scrubbed them away
+	bool tracks_end = (clean_end != span.end);
 
-		if (ch == '\\' && it->ch != Mch_end)
+	Byte_it_ctx_t ctx = {env_r, false};
+	Byte_it_t it = {span.begin, clean_end, &ctx};
+	while (*it != Mch_end)
+	{
+		Tokk_end_t<Byte_it_t> token = Lex_leading_token<Lang>(it);
+		if (token.end.it == clean_end)
 		{
-			++len;
-			++it;
+			ctx.hit_end = true;
 		}
-	}
 
-	// Reached end without seeing close quote
+		if (tracks_end && ctx.hit_end)
+			break;
+
+		Push_token_locs(sink_r, span, token.tokk, it.it, token.end.it);
+
+		it = token.end;
+	}
 
-	return Make_tokk_end(Tokk_unknown, it);
+	return (tracks_end && ctx.hit_end) ? it.it : span.end;
 }
 
-Ch_loc_t * After_whitespace(Ch_loc_t * it)
+template <typename Lang, typename Sink>
+void Lex_ary_tokens(
+	const Lex_env_t * env_r,
+	Arena_t * arena_r,
+	Byte_span_t span,
+	size_t off_start,
+	Scrub_scan_t scan,
+	Sink * sink_r)
 {
-	while (it->ch != Mch_end)
+	// Decode + scrub
+
+	Ch_loc_ary_t ary = Decode_byte_span(env_r->kernels_r, arena_r, span, off_start);
+	ary.env_r = env_r;
+
+	Scrub_ary(&ary, scan, arena_r);
+
+	// Lex!
+
+	Ary_it_t it = {ary.chs, &ary};
+	while (*it != Mch_end)
 	{
-		if (!Is_ws(it->ch))
-			break;
+		Tokk_end_t<Ary_it_t> token = Lex_leading_token<Lang>(it);
 
-		++it;
-	}
+		uint32_t off_begin = ary.offs[it.it - ary.chs];
+		uint32_t off_end = ary.offs[token.end.it - ary.chs];
 
-	return it;
+		Push_token(sink_r, token.tokk, off_begin, off_end - off_begin);
+
+		it = token.end;
+	}
 }
 
-Tokk_end_t Lex_leading_token(Ch_loc_t * it)
+template <typename Lang, typename Sink>
+void Lex_raw_tokens(
+	const Lex_env_t * env_r,
+	Arena_t * arena_r,
+	Byte_span_t span,
+	bool print_stats,
+	Sink * sink_r)
 {
-	char32_t ch_0 = it->ch;
-	char32_t ch_1 = (ch_0 == Mch_end) ? Mch_end : it[1].ch;
-	char32_t ch_2 = (ch_1 == Mch_end) ? Mch_end : it[2].ch;
+	Scrub_scan_t scan = Scan_for_scrub(env_r->kernels_r, span, Lang::has_trigraphs);
+
+	if (print_stats)
+	{
+		fprintf(stderr, "isa: %s\n", Str_from_isa(env_r->kernels_r->isa));
+		Print_scrub_stats(scan, Byte_span_len(span));
+	}
+
+	// Lex leading bytes that are all ascii, with nothing to scrub, directly.
+	//  For most files, that is the whole file.
+
+	// NOTE a BOM is not ascii, so files with one go straight to Lex_ary_tokens
 
-	if (ch_0 == 'u' && ch_1 == '8' && ch_2 == '"')
+	size_t len_clean = Len_leading_clean(env_r->kernels_r, span, scan);
+	Byte_t * rest_begin = span.begin;
+	if (len_clean)
 	{
-		it += 3;
-		return Lex_rest_of_str_lit(Tokk_utf8_string_literal, it);
+		rest_begin = Lex_clean_tokens<Lang>(env_r, span, len_clean, sink_r);
 	}
-	else if ((ch_0 == 'u' || ch_0 == 'U' || ch_0 == 'L') &&
-			 (ch_1 == '"' || ch_1 == '\''))
+
+	// Decode + scrub + lex whatever is left.
+	//  Every byte before rest_begin was its own ch, so rest_begin is the loc
+	//  of a ch, and scrubbing from there matches scrubbing the whole span.
+
+	if (rest_begin == span.end)
+		return;
+
+	size_t off_rest = (size_t)(rest_begin - span.begin);
+	Lex_ary_tokens<Lang>(env_r, arena_r, span, off_rest, scan, sink_r);
+}
+
+bool Are_tokens_equal(
+	Token_t token_0,
+	Token_t token_1)
+{
+	return token_0.tokk == token_1.tokk &&
+		   token_0.off == token_1.off &&
+		   token_0.len == token_1.len;
+}
+
+void Print_peek_mismatch(
+	size_t i_token,
+	Token_t token_peeked,
+	Token_t token)
+{
+	// On stdout, so it shows up as a diff against clang's tokens
+
+	printf(
+		"--peek : token %zu peeked as %s %u+%u, but was %s %u+%u\n",
+		i_token,
+		Str_from_tokk(token_peeked.tokk),
+		token_peeked.off,
+		token_peeked.len,
+		Str_from_tokk(token.tokk),
+		token.off,
+		token.len);
+}
+
+template <typename Lang>
+void Lex_raw_tokens_lazy(
+	const Lex_env_t * env_r,
+	Arena_t * arena_r,
+	Byte_span_t span,
+	bool peek,
+	Token_buf_t * buf_r)
+{
+	// Same as Lex_raw_tokens, but pulled one token at a time from a Lexer_t,
+	//  so decode + scrub happen on demand, as the lexer asks for chs,
+	//  and we never hold more than a small window of chs at a time
+
+	// With peek, we also Peek_token a different distance ahead (0 through
+	//  lexer_ring_len - 1) before each Next_token, and check every token we
+	//  peeked at against what Next_token hands back for it later. That runs
+	//  the ring through every fill level and wrap around.
+
+	Lexer_t<Lang> lexer;
+	Start_lexer(&lexer, env_r, arena_r, span);
+
+	Token_t peeked[lexer_ring_len];	// token i is in peeked[i & (lexer_ring_len - 1)]
+	size_t i_peeked_end = 0;		// every token before this has been peeked at
+
+	for (size_t i_token = 0; ; ++i_token)
 	{
-		it += 2;
+		if (peek)
+		{
+			size_t i_peek = (i_token * 3) & (lexer_ring_len - 1);
+			size_t i_token_peek = i_token + i_peek;
+
+			Token_t token_peek = Peek_token(&lexer, i_peek);
+			Token_t * peeked_r = &peeked[i_token_peek & (lexer_ring_len - 1)];
+
+			if (i_token_peek < i_peeked_end)
+			{
+				if (!Are_tokens_equal(*peeked_r, token_peek))
+				{
+					Print_peek_mismatch(i_token_peek, *peeked_r, token_peek);
+				}
+			}
+			else
+			{
+				// Anything between the last peek and this one is new too
+
+				size_t i_begin = (i_peeked_end > i_token) ? i_peeked_end : i_token;
+				for (size_t i = i_begin; i < i_token_peek; ++i)
+				{
+					peeked[i & (lexer_ring_len - 1)] = Peek_token(&lexer, i - i_token);
+				}
+
+				*peeked_r = token_peek;
+				i_peeked_end = i_token_peek + 1;
+			}
+		}
+
+		Token_t token = Next_token(&lexer);
 
-		Tokk_t tokk;
-		switch (ch_0)
+		if (i_token < i_peeked_end && !Are_tokens_equal(peeked[i_token & (lexer_ring_len - 1)], token))
 		{
-		case 'u':
-			tokk = (ch_1 == '"') ? Tokk_utf16_string_literal : Tokk_utf16_char_constant;
-			break;
-		case 'U':
-			tokk = (ch_1 == '"') ? Tokk_utf32_string_literal : Tokk_utf32_char_constant;
-			break;
-		default: // 'L'
-			tokk = (ch_1 == '"') ? Tokk_wide_string_literal : Tokk_wide_char_constant;
-			break;
+			Print_peek_mismatch(i_token, peeked[i_token & (lexer_ring_len - 1)], token);
 		}
 
-		return Lex_rest_of_str_lit(tokk, it);
+		if (token.tokk == Tokk_eof)
+			break;
+
+		Push_token(buf_r, token.tokk, token.off, token.len);
 	}
-	else if (ch_0 == '"' || ch_0 == '\'')
-	{
-		++it;
+}
 
-		Tokk_t tokk = (ch_0 == '"') ? Tokk_string_literal : Tokk_char_constant;
+template <typename Lang>
+void Lex_raw_tokens_sparse(
+	const Lex_env_t * env_r,
+	Arena_t * arena_r,
+	Byte_span_t span,
+	Token_buf_t * buf_r)
+{
+	// Same as Lex_raw_tokens, but we lex the raw bytes directly,
+	//  with a splice_map for the (rare) bits scrubbing changes,
+	//  instead of decoding every ch and loc up front
 
-		return Lex_rest_of_str_lit(tokk, it);
-	}
-	else if (ch_0 == '/' && ch_1 == '*')
-	{
-		it += 2;
-		return Lex_rest_of_block_comment(it);
-	}
-	else if (ch_0 == '/' && ch_1 == '/')
-	{
-		it += 2;
-		return Make_tokk_end(Tokk_comment, After_rest_of_line_comment(it));
-	}
-	else if (ch_0 == '.' && ch_1 >= '0' && ch_1 <= '9')
-	{
-		it += 2;
-		return Make_tokk_end(Tokk_numeric_constant, After_rest_of_ppnum(it));
-	}
-	else if (Starts_id(ch_0))
-	{
-		++it;
-		return Make_tokk_end(Tokk_raw_identifier, After_rest_of_id(it));
-	}
-	else if (ch_0 >= '0' && ch_0 <= '9')
+	Splice_map_t map = Build_splice_map(env_r->kernels_r, arena_r, span, Lang::has_trigraphs);
+	map.env_r = env_r;
+
+	// Lex!
+
+	Splice_it_t it = Start_splice_it(&map, map.off_first);
+	while (*it != Mch_end)
 	{
-		++it;
-		return Make_tokk_end(Tokk_numeric_constant, After_rest_of_ppnum(it));
+		Tokk_end_t<Splice_it_t> token = Lex_leading_token<Lang>(it);
+
+		Push_token(buf_r, token.tokk, it.off, token.end.off - it.off);
+
+		it = token.end;
 	}
-	else if (Is_ws(ch_0) || ch_0 == '\0')
+}
+
+template <typename Lang>
+Token_buf_t Lex_tokens(
+	const Lex_env_t * env_r,
+	Arena_t * arena_r,
+	Byte_span_t span,
+	bool lazy,
+	bool sparse,
+	bool peek,
+	bool print_stats)
+{
+	Token_buf_t buf = Start_token_buf(arena_r, Byte_span_len(span));
+
+	if (lazy)
 	{
-		++it;
-		return Make_tokk_end(Tokk_unknown, After_whitespace(it));
+		Lex_raw_tokens_lazy<Lang>(env_r, arena_r, span, peek, &buf);
 	}
-	else if (ch_0 == '\\')
+	else if (sparse)
 	{
-		Ch_end_t ucn = Lex_ucn(it);
-		if (ucn.end)
-		{
-			if (Starts_id(ucn.ch))
-			{
-				it = ucn.end;
-				return Make_tokk_end(Tokk_raw_identifier, After_rest_of_id(it));
-			}
-			else
-			{
-				// UCN that does not start an ID, return it as an unknown token
-
-				return Make_tokk_end(Tokk_unknown, ucn.end);
-			}
-		}
-		else
-		{
-			// Stray backslash, return as unknown token
-
-			return Make_tokk_end(Tokk_unknown, it + 1);
-		}
+		Lex_raw_tokens_sparse<Lang>(env_r, arena_r, span, &buf);
 	}
 	else
 	{
-		return Lex_punctuation(it);
+		Lex_raw_tokens<Lang>(env_r, arena_r, span, print_stats, &buf);
 	}
+
+	return buf;
 }
 
 
@@ -1748,208 +5158,554 @@ void Print_token(
 	printf("\n");
 }
 
-size_t Len_leading_line_break(
-	Byte_t * loc_begin,
-	Byte_t * loc_end)
+bool Is_skipped_by_pp(
+	Tokk_t tokk,
+	const Byte_t * loc_begin,
+	const Byte_t * loc_end)
 {
-	long long bytes_len = loc_end - loc_begin;
-	if (bytes_len <= 0)
-		return 0;
+	// The preprocessor skips comments and whitespace, and drops any stray
+	//  non-ascii ch (or invalid utf8 byte) spelled as utf8 instead of
+	//  returning it as an unknown token. Stray ucns are still unknown tokens.
 
-	Byte_t byte = loc_begin[0];
-	if (byte == '\n')
-		return 1;
+	if (tokk == Tokk_comment)
+		return true;
 
-	if (byte == '\r')
-	{
-		if (bytes_len >= 2 && loc_begin[1] == '\n')
-			return 2;
+	if (tokk != Tokk_unknown)
+		return false;
 
-		return 1;
-	}
+	if (loc_begin[0] >= 0x80)
+		return true;
 
-	return 0;
-}
+	// Whitespace tokens can start with line splices, skip those first
 
-void Advance_line_info(
-	Byte_t * loc_begin,
-	Byte_t * loc_end,
-	size_t * line_r,
-	size_t * col_r)
-{
 	while (loc_begin < loc_end)
 	{
-		size_t len = Len_leading_line_break(loc_begin, loc_end);
-		if (len)
+		const Byte_t * it = loc_begin;
+		if (it[0] == '\\')
 		{
-			loc_begin += len;
-
-			*line_r += 1;
-			*col_r = 1;
+			++it;
+		}
+		else if (loc_end - it >= 3 && it[0] == '?' && it[1] == '?' && it[2] == '/')
+		{
+			it += 3;
 		}
 		else
 		{
-			loc_begin += 1;
+			break;
+		}
+
+		while (it < loc_end && (*it == ' ' || *it == '\t' || *it == '\v' || *it == '\f'))
+		{
+			++it;
+		}
+
+		if (it == loc_end || (*it != '\n' && *it != '\r'))
+			return false; // stray backslash
+
+		// \r\n counts as one newline
 
-			*col_r += 1;
+		if (it[0] == '\r' && it + 1 < loc_end && it[1] == '\n')
+		{
+			++it;
 		}
+
+		loc_begin = it + 1;
+	}
+
+	if (loc_begin == loc_end)
+		return false;
+
+	switch (loc_begin[0])
+	{
+	case '\0':
+	case ' ':
+	case '\t':
+	case '\n':
+	case '\v':
+	case '\f':
+	case '\r':
+		return true;
+
+	default:
+		return false;
 	}
 }
 
-void Print_raw_tokens(Byte_span_t span)
+uint32_t Off_eof(Byte_span_t span)
 {
-	// Decode + scrub
+	// Where clang puts the eof token : on the last newline, if the
+	//  file ends with one, rather than on the line after it
 
-	Ch_loc_t * ary = Decode_byte_span(span);
+	Byte_t * end = span.end;
+	if (end != span.begin && (end[-1] == '\n' || end[-1] == '\r'))
+	{
+		--end;
 
-	Scrub_carriage_returns(ary);
-	Scrub_trigraphs(ary);
-	Scrub_escaped_line_breaks(ary);
+		// \r\n or \n\r
 
-	// Keep track of line info
+		if (end != span.begin && (end[-1] == '\n' || end[-1] == '\r') && end[-1] != end[0])
+		{
+			--end;
+		}
+	}
 
-	size_t line = 1;
-	size_t col = 1;
+	return (uint32_t)(end - span.begin);
+}
 
-	// Lex!
+void Print_token_buf(
+	Byte_span_t span,
+	const Line_table_t * lines_r,
+	const Col_index_t * cols_r,
+	const Token_buf_t * buf_r,
+	bool pp)
+{
+	// Tokens come in order, so just step through the lines.
+	//  With pp set, print what clang -dump-tokens does instead of
+	//  -dump-raw-tokens : only what the preprocessor hands the parser, then eof.
+
+	Line_cursor_t line_cursor = {lines_r, 0};
 
-	Ch_loc_t * it = ary;
-	while (it->ch != Mch_end)
+	for (size_t i = 0; i < buf_r->len; ++i)
 	{
-		Tokk_end_t token = Lex_leading_token(it);
+		Byte_t * loc_begin = span.begin + buf_r->offs[i];
+		Byte_t * loc_end = loc_begin + buf_r->lens[i];
+
+		if (pp && Is_skipped_by_pp((Tokk_t)buf_r->tokks[i], loc_begin, loc_end))
+			continue;
 
-		Byte_t * loc_begin = it->loc;
-		Byte_t * loc_end = token.end->loc;
+		size_t line;
+		size_t col;
+		Advance_line_cursor(&line_cursor, buf_r->offs[i], &line, &col);
+		col = Col_from_byte_col(cols_r, line, buf_r->offs[i], col);
 
 		Print_token(
-			token.tokk,
+			(Tokk_t)buf_r->tokks[i],
 			loc_begin,
 			loc_end,
 			line,
 			col);
+	}
 
-		Advance_line_info(
-			loc_begin,
-			loc_end,
-			&line,
-			&col);
+	if (pp)
+	{
+		uint32_t off = Off_eof(span);
 
-		it = token.end;
+		size_t line;
+		size_t col;
+		Advance_line_cursor(&line_cursor, off, &line, &col);
+		col = Col_from_byte_col(cols_r, line, off, col);
+
+		Print_token(Tokk_eof, span.begin + off, span.begin + off, line, col);
 	}
 }
 
 
 
-// main
+// library : see ctok.h
 
-int wmain(int argc, wchar_t *argv[])
+bool Lex_bytes(
+	const Lex_opts_t * opts_r,
+	Arena_t * arena_r,
+	const uint8_t * bytes,
+	size_t len,
+	Visit_token_t visit,
+	void * user_r)
 {
-	// Get file path
+	// offs are 32 bits
+
+	if (len >= UINT32_MAX)
+		return false;
+
+	// NOTE we never write through span, the lexer just is not const correct
+
+	Byte_span_t span;
+	span.begin = (Byte_t *)bytes;
+	span.end = (Byte_t *)bytes + len;
 
-	if (argc != 2)
+	// cpuid is not free, so only ask once. Static init is thread safe,
+	//  and every thread would get the same answer anyway
+
+	static const Kernels_t * kernels_best_r = Kernels_from_isa(Isa_best());
+
+	// Running out of memory jumps back here (see Arena_oom_t)
+
+	Arena_oom_t oom;
+	arena_r->oom_r = &oom;
+
+	if (setjmp(oom.jmp))
 	{
-		printf(
-			"wrong number of arguments, "
-			"only expected a file path\n");
+		arena_r->oom_r = NULL;
+		Reset_arena(arena_r);
 
-		return 1;
+		return false;
 	}
-	wchar_t * path = argv[1];
 
-	// Read file
+	Lex_env_t env;
+	env.kernels_r = kernels_best_r;
+	env.id_tables_r = Id_tables_from_lang(opts_r->lang);
+	env.kwd_mask = (opts_r->keywords) ? Kwd_mask_from_lang(opts_r->lang) : 0;
+
+	Line_table_t lines = Build_line_table(env.kernels_r, arena_r, span);
+	Col_index_t cols = Build_col_index(env.kernels_r, arena_r, span, &lines, opts_r->col_unit);
+
+	Token_visitor_t visitor = {visit, user_r, {&lines, 0}, &cols};
+
+	switch (opts_r->lang)
+	{
+	case Lang_c89:
+		Lex_raw_tokens<Lang_c89_t>(&env, arena_r, span, false, &visitor);
+		break;
+
+	case Lang_c11:
+		Lex_raw_tokens<Lang_c11_t>(&env, arena_r, span, false, &visitor);
+		break;
+
+	case Lang_c23:
+		Lex_raw_tokens<Lang_c23_t>(&env, arena_r, span, false, &visitor);
+		break;
+
+	case Lang_cxx17:
+		Lex_raw_tokens<Lang_cxx17_t>(&env, arena_r, span, false, &visitor);
+		break;
+
+	case Lang_cxx20:
+		Lex_raw_tokens<Lang_cxx20_t>(&env, arena_r, span, false, &visitor);
+		break;
+	}
+
+	arena_r->oom_r = NULL;
+	Reset_arena(arena_r);
+
+	return true;
+}
+
+
+
+// main : the ctok exe. Build with CTOK_LIB defined to leave it out
+
+#if !defined(CTOK_LIB)
+
+int wmain(int argc, wchar_t *argv[])
+{
+	// Get options + file path
+
+	bool lazy = false;
+	bool peek = false;
+	bool sparse = false;
+	bool print_stats = false;
+	bool quiet = false;
+	int path_count = 0;
+
+	// Byte cols by default, same as clang
+
+	Col_unit_k col_unit = Col_unit_bytes;
+
+	// C11 by default, same as test.py gives clang
+
+	Lang_k lang = Lang_c11;
+
+	bool keywords = false;
+
+	Isa_k isa_best = Isa_best();
+	Isa_k isa = isa_best;
 
-	Byte_t * file_bytes;
-	size_t file_length;
+	for (int i_arg = 1; i_arg < argc; ++i_arg)
 	{
-		FILE * file = _wfopen(path, L"rb");
-		if (!file)
+		wchar_t * arg = argv[i_arg];
+
+		if (wcscmp(arg, L"--lazy") == 0)
 		{
-			printf(
-				"Failed to open file '%ls'.\n", 
-				path);
-			
-			return 1;
+			lazy = true;
+		}
+		else if (wcscmp(arg, L"--sparse") == 0)
+		{
+			sparse = true;
 		}
+		else if (wcscmp(arg, L"--peek") == 0)
+		{
+			// --lazy, checking Peek_token against Next_token as we go
 
-		// get file length 
-		//  (seek to end, ftell, seek back to start)
+			lazy = true;
+			peek = true;
+		}
+		else if (wcscmp(arg, L"--stats") == 0)
+		{
+			print_stats = true;
+		}
+		else if (wcscmp(arg, L"--quiet") == 0)
+		{
+			// Lex, but do not print tokens (for timing the lexer by itself)
 
-		if (fseek(file, 0, SEEK_END))
+			quiet = true;
+		}
+		else if (wcscmp(arg, L"--columns=bytes") == 0)
 		{
-			printf(
-				"fseek '%ls' SEEK_END failed.\n", 
-				path);
-			
-			return 1;
+			col_unit = Col_unit_bytes;
+		}
+		else if (wcscmp(arg, L"--columns=codepoints") == 0)
+		{
+			col_unit = Col_unit_codepoints;
+		}
+		else if (wcscmp(arg, L"--columns=utf16") == 0)
+		{
+			col_unit = Col_unit_utf16;
 		}
+		else if (wcscmp(arg, L"--keywords") == 0)
+		{
+			// Keywords (and ids) go with -std=, same as Lex_opts_t
 
-		long signed_file_length = ftell(file);
-		if (signed_file_length < 0)
+			keywords = true;
+		}
+		else if (wcscmp(arg, L"-std=c89") == 0)
+		{
+			lang = Lang_c89;
+		}
+		else if (wcscmp(arg, L"-std=c11") == 0)
+		{
+			lang = Lang_c11;
+		}
+		else if (wcscmp(arg, L"-std=c23") == 0 || wcscmp(arg, L"-std=c2x") == 0)
+		{
+			lang = Lang_c23;
+		}
+		else if (wcscmp(arg, L"-std=c++17") == 0)
+		{
+			lang = Lang_cxx17;
+		}
+		else if (wcscmp(arg, L"-std=c++20") == 0)
+		{
+			lang = Lang_cxx20;
+		}
+		else if (wcscmp(arg, L"--isa=scalar") == 0)
+		{
+			isa = Isa_scalar;
+		}
+		else if (wcscmp(arg, L"--isa=sse2") == 0)
+		{
+			isa = Isa_sse2;
+		}
+		else if (wcscmp(arg, L"--isa=avx2") == 0)
+		{
+			isa = Isa_avx2;
+		}
+		else if (wcscmp(arg, L"--isa=avx512") == 0)
+		{
+			isa = Isa_avx512;
+		}
+		else if (arg[0] == L'-')
 		{
 			printf(
-				"ftell '%ls' failed.\n", 
-				path);
-			
+				"unexpected option '%ls'\n",
+				arg);
+
 			return 1;
 		}
+		else
+		{
+			++path_count;
+		}
+	}
+
+	if (!path_count)
+	{
+		printf(
+			"wrong number of arguments, "
+			"expected at least one file path\n");
+
+		return 1;
+	}
+
+	// Each isa includes the ones before it, so anything up to the best one works
+
+	if (isa > isa_best)
+	{
+		printf(
+			"--isa=%s is not supported on this cpu, "
+			"the best it can do is --isa=%s\n",
+			Str_from_isa(isa),
+			Str_from_isa(isa_best));
+
+		return 1;
+	}
+
+	uint32_t kwd_mask = (keywords) ? Kwd_mask_from_lang(lang) : 0;
+	Lex_env_t env = {Kernels_from_isa(isa), Id_tables_from_lang(lang), kwd_mask};
+
+	// Lex each file in turn, all out of one arena. Once it has seen a file
+	//  as big as the next one, lexing that file does not call malloc at all
 
-		file_length = (size_t)signed_file_length;
+	Arena_t arena = {};
 
-		if (fseek(file, 0, SEEK_SET))
+	for (int i_arg = 1; i_arg < argc; ++i_arg)
+	{
+		wchar_t * path = argv[i_arg];
+		if (path[0] == L'-')
+			continue;
+
+		size_t len_mallocs_start = arena.len_mallocs;
+
+		Reset_arena(&arena);
+
+		// Read file
+
+		Byte_t * file_bytes;
+		size_t file_length;
 		{
-			printf(
-				"fseek '%ls' SEEK_SET failed.\n", 
-				path);
+			FILE * file = _wfopen(path, L"rb");
+			if (!file)
+			{
+				printf(
+					"Failed to open file '%ls'.\n", 
+					path);
 			
-			return 1;
+				return 1;
+			}
+
+			// get file length 
+			//  (seek to end, ftell, seek back to start)
+
+			if (fseek(file, 0, SEEK_END))
+			{
+				printf(
+					"fseek '%ls' SEEK_END failed.\n", 
+					path);
+			
+				return 1;
+			}
+
+			long signed_file_length = ftell(file);
+			if (signed_file_length < 0)
+			{
+				printf(
+					"ftell '%ls' failed.\n", 
+					path);
+			
+				return 1;
+			}
+
+			file_length = (size_t)signed_file_length;
+
+			if (fseek(file, 0, SEEK_SET))
+			{
+				printf(
+					"fseek '%ls' SEEK_SET failed.\n", 
+					path);
+			
+				return 1;
+			}
+
+			// Allocate space to read file
+
+			file_bytes = (Byte_t *)Alloc_arena(&arena, file_length);
+			if (!file_bytes)
+			{
+				printf(
+					"failed to allocate %zu bytes "
+					"to read '%ls'.\n", 
+					file_length, 
+					path);
+			
+				return 1;
+			}
+
+			// Actually read
+
+			size_t bytes_read = fread(
+									file_bytes, 
+									1, 
+									file_length,
+									file);
+
+			if (bytes_read != file_length)
+			{
+				printf(
+					"failed to read %zu bytes from '%ls', "
+					"only read %zu bytes.\n",
+					file_length, 
+					path,
+					bytes_read);
+
+				return 1;
+			}
+
+			// close file
+
+			// BUG (matthewd) ignoring return value?
+
+			fclose(file);
 		}
 
-		// Allocate space to read file
+		// Lex tokens
+
+		Byte_span_t span;
+		span.begin = file_bytes;
+		span.end = file_bytes + file_length;
+
+		// Running out of memory jumps back here (see Arena_oom_t)
 
-		file_bytes = (Byte_t *)calloc(file_length, 1);
-		if (!file_bytes)
+		Arena_oom_t oom;
+		arena.oom_r = &oom;
+
+		if (setjmp(oom.jmp))
 		{
 			printf(
-				"failed to allocate %zu bytes "
-				"to read '%ls'.\n", 
-				file_length, 
+				"ran out of memory lexing '%ls'.\n",
 				path);
-			
+
 			return 1;
 		}
 
-		// Actually read
+		Token_buf_t buf = {};
+		switch (lang)
+		{
+		case Lang_c89:
+			buf = Lex_tokens<Lang_c89_t>(&env, &arena, span, lazy, sparse, peek, print_stats);
+			break;
 
-		size_t bytes_read = fread(
-								file_bytes, 
-								1, 
-								file_length,
-								file);
+		case Lang_c11:
+			buf = Lex_tokens<Lang_c11_t>(&env, &arena, span, lazy, sparse, peek, print_stats);
+			break;
 
-		if (bytes_read != file_length)
-		{
-			printf(
-				"failed to read %zu bytes from '%ls', "
-				"only read %zu bytes.\n",
-				file_length, 
-				path,
-				bytes_read);
+		case Lang_c23:
+			buf = Lex_tokens<Lang_c23_t>(&env, &arena, span, lazy, sparse, peek, print_stats);
+			break;
 
-			return 1;
+		case Lang_cxx17:
+			buf = Lex_tokens<Lang_cxx17_t>(&env, &arena, span, lazy, sparse, peek, print_stats);
+			break;
+
+		case Lang_cxx20:
+			buf = Lex_tokens<Lang_cxx20_t>(&env, &arena, span, lazy, sparse, peek, print_stats);
+			break;
 		}
 
-		// close file
+		if (print_stats)
+		{
+			fprintf(stderr, "tokens: %zu\n", buf.len);
+		}
 
-		// BUG (matthewd) ignoring return value?
+		// Print tokens
 
-		fclose(file);
-	}
+		if (!quiet)
+		{
+			Line_table_t lines = Build_line_table(env.kernels_r, &arena, span);
+			Col_index_t cols = Build_col_index(env.kernels_r, &arena, span, &lines, col_unit);
+			Print_token_buf(span, &lines, &cols, &buf, keywords);
+		}
 
-	// Print tokens
+		arena.oom_r = NULL;
 
-	Byte_span_t span;
-	span.begin = file_bytes;
-	span.end = file_bytes + file_length;
+		if (print_stats)
+		{
+			fprintf(
+				stderr,
+				"arena: %zu mallocs (%zu in all)\n",
+				arena.len_mallocs - len_mallocs_start,
+				arena.len_mallocs);
+		}
+	}
+
+	Free_arena(&arena);
+}
 
-	Print_raw_tokens(span);
-}
\ No newline at end of file
+#endif // !CTOK_LIB
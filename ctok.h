@@ -0,0 +1,537 @@
+// ctok.h : lex C/C++ source from a buffer you own, calling your visitor for each token.
+//  Link against ctok.lib (ctok.c built with CTOK_LIB defined, see build.bat)
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Token kinds, named (and ordered) like clang's
+
+#define TOKEN_KINDS()\
+	X(unknown)\
+	X(eof)\
+	X(eod)\
+	X(code_completion)\
+	X(comment)\
+	X(identifier)\
+	X(raw_identifier)\
+	X(numeric_constant)\
+	X(char_constant)\
+	X(wide_char_constant)\
+	X(utf8_char_constant)\
+	X(utf16_char_constant)\
+	X(utf32_char_constant)\
+	X(string_literal)\
+	X(wide_string_literal)\
+	X(header_name)\
+	X(utf8_string_literal)\
+	X(utf16_string_literal)\
+	X(utf32_string_literal)\
+	X(l_square)\
+	X(r_square)\
+	X(l_paren)\
+	X(r_paren)\
+	X(l_brace)\
+	X(r_brace)\
+	X(period)\
+	X(ellipsis)\
+	X(amp)\
+	X(ampamp)\
+	X(ampequal)\
+	X(star)\
+	X(starequal)\
+	X(plus)\
+	X(plusplus)\
+	X(plusequal)\
+	X(minus)\
+	X(arrow)\
+	X(minusminus)\
+	X(minusequal )\
+	X(tilde)\
+	X(exclaim)\
+	X(exclaimequal)\
+	X(slash)\
+	X(slashequal)\
+	X(percent)\
+	X(percentequal)\
+	X(less)\
+	X(lessless)\
+	X(lessequal)\
+	X(lesslessequal)\
+	X(spaceship)\
+	X(greater)\
+	X(greatergreater)\
+	X(greaterequal)\
+	X(greatergreaterequal)\
+	X(caret)\
+	X(caretequal)\
+	X(pipe)\
+	X(pipepipe)\
+	X(pipeequal)\
+	X(question)\
+	X(colon)\
+	X(semi)\
+	X(equal)\
+	X(equalequal)\
+	X(comma)\
+	X(hash)\
+	X(hashhash)\
+	X(hashat)\
+	X(periodstar)\
+	X(arrowstar)\
+	X(coloncolon)\
+	X(at)\
+	X(lesslessless)\
+	X(greatergreatergreater)\
+	X(caretcaret)\
+\
+	X(kw_auto)\
+	X(kw_break)\
+	X(kw_case)\
+	X(kw_char)\
+	X(kw_const)\
+	X(kw_continue)\
+	X(kw_default)\
+	X(kw_do)\
+	X(kw_double)\
+	X(kw_else)\
+	X(kw_enum)\
+	X(kw_extern)\
+	X(kw_float)\
+	X(kw_for)\
+	X(kw_goto)\
+	X(kw_if)\
+	X(kw_int)\
+	X(kw__ExtInt)\
+	X(kw__BitInt)\
+	X(kw_long)\
+	X(kw_register)\
+	X(kw_return)\
+	X(kw_short)\
+	X(kw_signed)\
+	X(kw_sizeof)\
+	X(kw_static)\
+	X(kw_struct)\
+	X(kw_switch)\
+	X(kw_typedef)\
+	X(kw_union)\
+	X(kw_unsigned)\
+	X(kw_void)\
+	X(kw_volatile)\
+	X(kw_while)\
+	X(kw__Alignas)\
+	X(kw__Alignof)\
+	X(kw__Atomic)\
+	X(kw__Bool)\
+	X(kw__Complex)\
+	X(kw__Generic)\
+	X(kw__Imaginary)\
+	X(kw__Noreturn)\
+	X(kw__Static_assert)\
+	X(kw__Thread_local)\
+	X(kw___func__)\
+	X(kw___objc_yes)\
+	X(kw___objc_no)\
+	X(kw_asm)\
+	X(kw_bool)\
+	X(kw_catch)\
+	X(kw_class)\
+	X(kw_const_cast)\
+	X(kw_delete)\
+	X(kw_dynamic_cast)\
+	X(kw_explicit)\
+	X(kw_export)\
+	X(kw_false)\
+	X(kw_friend)\
+	X(kw_mutable)\
+	X(kw_namespace)\
+	X(kw_new)\
+	X(kw_operator)\
+	X(kw_private)\
+	X(kw_protected)\
+	X(kw_public)\
+	X(kw_reinterpret_cast)\
+	X(kw_static_cast)\
+	X(kw_template)\
+	X(kw_this)\
+	X(kw_throw)\
+	X(kw_true)\
+	X(kw_try)\
+	X(kw_typename)\
+	X(kw_typeid)\
+	X(kw_using)\
+	X(kw_virtual)\
+	X(kw_wchar_t)\
+	X(kw_restrict)\
+	X(kw_inline)\
+	X(kw_alignas)\
+	X(kw_alignof)\
+	X(kw_char16_t)\
+	X(kw_char32_t)\
+	X(kw_constexpr)\
+	X(kw_decltype)\
+	X(kw_noexcept)\
+	X(kw_nullptr)\
+	X(kw_static_assert)\
+	X(kw_thread_local)\
+	X(kw_co_await)\
+	X(kw_co_return)\
+	X(kw_co_yield)\
+	X(kw_module)\
+	X(kw_import)\
+	X(kw_consteval)\
+	X(kw_constinit)\
+	X(kw_concept)\
+	X(kw_requires)\
+	X(kw_char8_t)\
+	X(kw__Float16)\
+	X(kw_typeof)\
+	X(kw_typeof_unqual)\
+	X(kw__Accum)\
+	X(kw__Fract)\
+	X(kw__Sat)\
+	X(kw__Decimal32)\
+	X(kw__Decimal64)\
+	X(kw__Decimal128)\
+	X(kw___null)\
+	X(kw___alignof)\
+	X(kw___attribute)\
+	X(kw___builtin_choose_expr)\
+	X(kw___builtin_offsetof)\
+	X(kw___builtin_FILE)\
+	X(kw___builtin_FILE_NAME)\
+	X(kw___builtin_FUNCTION)\
+	X(kw___builtin_FUNCSIG)\
+	X(kw___builtin_LINE)\
+	X(kw___builtin_COLUMN)\
+	X(kw___builtin_source_location)\
+	X(kw___builtin_types_compatible_p)\
+	X(kw___builtin_va_arg)\
+	X(kw___extension__)\
+	X(kw___float128)\
+	X(kw___ibm128)\
+	X(kw___imag)\
+	X(kw___int128)\
+	X(kw___label__)\
+	X(kw___real)\
+	X(kw___thread)\
+	X(kw___FUNCTION__)\
+	X(kw___PRETTY_FUNCTION__)\
+	X(kw___auto_type)\
+	X(kw___FUNCDNAME__)\
+	X(kw___FUNCSIG__)\
+	X(kw_L__FUNCTION__)\
+	X(kw_L__FUNCSIG__)\
+	X(kw___is_interface_class)\
+	X(kw___is_sealed)\
+	X(kw___is_destructible)\
+	X(kw___is_trivially_destructible)\
+	X(kw___is_nothrow_destructible)\
+	X(kw___is_nothrow_assignable)\
+	X(kw___is_constructible)\
+	X(kw___is_nothrow_constructible)\
+	X(kw___is_assignable)\
+	X(kw___has_nothrow_move_assign)\
+	X(kw___has_trivial_move_assign)\
+	X(kw___has_trivial_move_constructor)\
+	X(kw___has_nothrow_assign)\
+	X(kw___has_nothrow_copy)\
+	X(kw___has_nothrow_constructor)\
+	X(kw___has_trivial_assign)\
+	X(kw___has_trivial_copy)\
+	X(kw___has_trivial_constructor)\
+	X(kw___has_trivial_destructor)\
+	X(kw___has_virtual_destructor)\
+	X(kw___is_abstract)\
+	X(kw___is_aggregate)\
+	X(kw___is_base_of)\
+	X(kw___is_class)\
+	X(kw___is_convertible_to)\
+	X(kw___is_empty)\
+	X(kw___is_enum)\
+	X(kw___is_final)\
+	X(kw___is_literal)\
+	X(kw___is_pod)\
+	X(kw___is_polymorphic)\
+	X(kw___is_standard_layout)\
+	X(kw___is_trivial)\
+	X(kw___is_trivially_assignable)\
+	X(kw___is_trivially_constructible)\
+	X(kw___is_trivially_copyable)\
+	X(kw___is_union)\
+	X(kw___has_unique_object_representations)\
+	X(kw___add_lvalue_reference)\
+	X(kw___add_pointer)\
+	X(kw___add_rvalue_reference)\
+	X(kw___decay)\
+	X(kw___make_signed)\
+	X(kw___make_unsigned)\
+	X(kw___remove_all_extents)\
+	X(kw___remove_const)\
+	X(kw___remove_cv)\
+	X(kw___remove_cvref)\
+	X(kw___remove_extent)\
+	X(kw___remove_pointer)\
+	X(kw___remove_reference_t)\
+	X(kw___remove_restrict)\
+	X(kw___remove_volatile)\
+	X(kw___underlying_type)\
+	X(kw___is_trivially_relocatable)\
+	X(kw___is_trivially_equality_comparable)\
+	X(kw___is_bounded_array)\
+	X(kw___is_unbounded_array)\
+	X(kw___is_nullptr)\
+	X(kw___is_scoped_enum)\
+	X(kw___is_referenceable)\
+	X(kw___can_pass_in_regs)\
+	X(kw___reference_binds_to_temporary)\
+	X(kw___is_lvalue_expr)\
+	X(kw___is_rvalue_expr)\
+	X(kw___is_arithmetic)\
+	X(kw___is_floating_point)\
+	X(kw___is_integral)\
+	X(kw___is_complete_type)\
+	X(kw___is_void)\
+	X(kw___is_array)\
+	X(kw___is_function)\
+	X(kw___is_reference)\
+	X(kw___is_lvalue_reference)\
+	X(kw___is_rvalue_reference)\
+	X(kw___is_fundamental)\
+	X(kw___is_object)\
+	X(kw___is_scalar)\
+	X(kw___is_compound)\
+	X(kw___is_pointer)\
+	X(kw___is_member_object_pointer)\
+	X(kw___is_member_function_pointer)\
+	X(kw___is_member_pointer)\
+	X(kw___is_const)\
+	X(kw___is_volatile)\
+	X(kw___is_signed)\
+	X(kw___is_unsigned)\
+	X(kw___is_same)\
+	X(kw___is_convertible)\
+	X(kw___array_rank)\
+	X(kw___array_extent)\
+	X(kw___private_extern__)\
+	X(kw___module_private__)\
+	X(kw___declspec)\
+	X(kw___cdecl)\
+	X(kw___stdcall)\
+	X(kw___fastcall)\
+	X(kw___thiscall)\
+	X(kw___regcall)\
+	X(kw___vectorcall)\
+	X(kw___forceinline)\
+	X(kw___unaligned)\
+	X(kw___super)\
+	X(kw___global)\
+	X(kw___local)\
+	X(kw___constant)\
+	X(kw___private)\
+	X(kw___generic)\
+	X(kw___kernel)\
+	X(kw___read_only)\
+	X(kw___write_only)\
+	X(kw___read_write)\
+	X(kw___builtin_astype)\
+	X(kw_vec_step)\
+	X(kw_image1d_t)\
+	X(kw_image1d_array_t)\
+	X(kw_image1d_buffer_t)\
+	X(kw_image2d_t)\
+	X(kw_image2d_array_t)\
+	X(kw_image2d_depth_t)\
+	X(kw_image2d_array_depth_t)\
+	X(kw_image2d_msaa_t)\
+	X(kw_image2d_array_msaa_t)\
+	X(kw_image2d_msaa_depth_t)\
+	X(kw_image2d_array_msaa_depth_t)\
+	X(kw_image3d_t)\
+	X(kw_pipe)\
+	X(kw_addrspace_cast)\
+	X(kw___noinline__)\
+	X(kw_cbuffer)\
+	X(kw_tbuffer)\
+	X(kw_groupshared)\
+	X(kw___builtin_omp_required_simd_align)\
+	X(kw___pascal)\
+	X(kw___vector)\
+	X(kw___pixel)\
+	X(kw___bool)\
+	X(kw___bf16)\
+	X(kw_half)\
+	X(kw___bridge)\
+	X(kw___bridge_transfer)\
+	X(kw___bridge_retained)\
+	X(kw___bridge_retain)\
+	X(kw___covariant)\
+	X(kw___contravariant)\
+	X(kw___kindof)\
+	X(kw__Nonnull)\
+	X(kw__Nullable)\
+	X(kw__Nullable_result)\
+	X(kw__Null_unspecified)\
+	X(kw___funcref)\
+	X(kw___ptr64)\
+	X(kw___ptr32)\
+	X(kw___sptr)\
+	X(kw___uptr)\
+	X(kw___w64)\
+	X(kw___uuidof)\
+	X(kw___try)\
+	X(kw___finally)\
+	X(kw___leave)\
+	X(kw___int64)\
+	X(kw___if_exists)\
+	X(kw___if_not_exists)\
+	X(kw___single_inheritance)\
+	X(kw___multiple_inheritance)\
+	X(kw___virtual_inheritance)\
+	X(kw___interface)\
+	X(kw___builtin_convertvector)\
+	X(kw___builtin_bit_cast)\
+	X(kw___builtin_available)\
+	X(kw___builtin_sycl_unique_stable_name)\
+	X(kw___arm_streaming)\
+	X(kw___unknown_anytype)\
+\
+	X(annot_cxxscope)\
+	X(annot_typename)\
+	X(annot_template_id)\
+	X(annot_non_type)\
+	X(annot_non_type_undeclared)\
+	X(annot_non_type_dependent)\
+	X(annot_overload_set)\
+	X(annot_primary_expr)\
+	X(annot_decltype)\
+	X(annot_pragma_unused)\
+	X(annot_pragma_vis)\
+	X(annot_pragma_pack)\
+	X(annot_pragma_parser_crash)\
+	X(annot_pragma_captured)\
+	X(annot_pragma_dump)\
+	X(annot_pragma_msstruct)\
+	X(annot_pragma_align)\
+	X(annot_pragma_weak)\
+	X(annot_pragma_weakalias)\
+	X(annot_pragma_redefine_extname)\
+	X(annot_pragma_fp_contract)\
+	X(annot_pragma_fenv_access)\
+	X(annot_pragma_fenv_access_ms)\
+	X(annot_pragma_fenv_round)\
+	X(annot_pragma_float_control)\
+	X(annot_pragma_ms_pointers_to_members)\
+	X(annot_pragma_ms_vtordisp)\
+	X(annot_pragma_ms_pragma)\
+	X(annot_pragma_opencl_extension)\
+	X(annot_attr_openmp)\
+	X(annot_pragma_openmp)\
+	X(annot_pragma_openmp_end)\
+	X(annot_pragma_loop_hint)\
+	X(annot_pragma_fp)\
+	X(annot_pragma_attribute)\
+	X(annot_pragma_riscv)\
+	X(annot_module_include)\
+	X(annot_module_begin)\
+	X(annot_module_end)\
+	X(annot_header_unit)\
+	X(annot_repl_input_end)
+
+typedef enum Tokk_t
+{
+	#define X(id) Tokk_##id,
+	TOKEN_KINDS()
+	#undef X
+} Tokk_t;
+
+const char * Str_from_tokk(Tokk_t tokk);
+
+typedef enum Lang_k // -std=
+{
+	Lang_c89,
+	Lang_c11,
+	Lang_c23,
+	Lang_cxx17,
+	Lang_cxx20,
+} Lang_k;
+
+typedef enum Col_unit_k // what col counts, --columns=
+{
+	Col_unit_bytes,			// like clang
+	Col_unit_codepoints,
+	Col_unit_utf16,			// like editors that speak LSP
+} Col_unit_k;
+
+typedef struct Lex_opts_t
+{
+	Lang_k lang;
+
+	// Turn ids that are keywords in lang into Tokk_kw_*, instead of
+	//  leaving every id a Tokk_raw_identifier (like clang -dump-raw-tokens)
+
+	bool keywords;
+
+	Col_unit_k col_unit;
+} Lex_opts_t;
+
+// Scratch memory for Lex_bytes. Start with Arena_t arena = {}, keep one per thread,
+//  and Free_arena when done. Lex_bytes resets it before returning, but holds on to
+//  the biggest block, so once it has seen a file as big as the next, it never mallocs
+
+typedef struct Arena_t
+{
+	struct Arena_block_t * block_r;
+	size_t len; // bytes used in block_r
+
+	size_t len_mallocs; // every malloc the arena has ever done, to check the above
+
+	size_t block_cap_max; // biggest block the arena will malloc, 0 for no limit. Past that, Lex_bytes runs out of memory
+
+	struct Arena_oom_t * oom_r; // only set while lexing, leave it NULL
+} Arena_t;
+
+void Reset_arena(Arena_t * arena_r);
+void Free_arena(Arena_t * arena_r);
+
+// Called once per token, in order. Offs are bytes from the start of the buffer,
+//  line + col start at 1, and col counts opts_r->col_unit (bytes, unless you ask)
+
+typedef void (* Visit_token_t)(
+	void * user_r,
+	Tokk_t tokk,
+	uint32_t off_begin,
+	uint32_t off_end,
+	uint32_t line,
+	uint32_t col);
+
+// Lex len bytes, calling visit(user_r, ...) for each token.
+//  Returns false (without calling visit) if len does not fit in 32 bits.
+//  Also returns false if arena_r runs out of memory partway through,
+//  after visiting the tokens before that point.
+
+// There is no global state (past which kernels the cpu can run, found on the first
+//  call), so lexing different buffers on different threads (each with its own arena)
+//  is fine. Nothing is allocated per token. The only memory we need, out of arena_r,
+//  is a table of where each line starts (plus where the non-ascii chs are, for
+//  col_unit other than bytes), and room for bytes that need decoding or scrubbing
+//  (non-ascii, trigraphs, escaped line breaks, carriage returns), from the first
+//  such byte on.
+
+bool Lex_bytes(
+	const Lex_opts_t * opts_r,
+	Arena_t * arena_r,
+	const uint8_t * bytes,
+	size_t len,
+	Visit_token_t visit,
+	void * user_r);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,140 @@
+import unicodedata
+
+# Generates id_tables.h, the two-stage tables Starts_id/Extends_id use for code points >= 0x80.
+#  Run this from the repo root, and check in the result.
+
+# Each table set has a 'start' and a 'continue' property. We split the code space into
+#  256 code point blocks, store each distinct block once as a 256 bit bitset,
+#  and map each block to its bitset with a one byte index.
+
+out_path = "id_tables.h"
+
+block_len = 256
+block_count = 0x110000 // block_len
+
+# C11 rules, as clang implements them (C11 D.1 and D.2).
+#  These are the ranges that used to be hard coded in Extends_id/Starts_id
+
+c11_continue_ranges = [
+	(0x00A8, 0x00A8), (0x00AA, 0x00AA), (0x00AD, 0x00AD),
+	(0x00AF, 0x00AF), (0x00B2, 0x00B5), (0x00B7, 0x00BA),
+	(0x00BC, 0x00BE), (0x00C0, 0x00D6), (0x00D8, 0x00F6),
+	(0x00F8, 0x00FF),
+
+	(0x0100, 0x167F), (0x1681, 0x180D), (0x180F, 0x1FFF),
+
+	(0x200B, 0x200D), (0x202A, 0x202E), (0x203F, 0x2040),
+	(0x2054, 0x2054), (0x2060, 0x206F),
+
+	(0x2070, 0x218F), (0x2460, 0x24FF), (0x2776, 0x2793),
+	(0x2C00, 0x2DFF), (0x2E80, 0x2FFF),
+
+	(0x3004, 0x3007), (0x3021, 0x302F), (0x3031, 0x303F),
+
+	(0x3040, 0xD7FF),
+
+	(0xF900, 0xFD3D), (0xFD40, 0xFDCF), (0xFDF0, 0xFE44),
+	(0xFE47, 0xFFFD),
+
+	(0x10000, 0x1FFFD), (0x20000, 0x2FFFD), (0x30000, 0x3FFFD),
+	(0x40000, 0x4FFFD), (0x50000, 0x5FFFD), (0x60000, 0x6FFFD),
+	(0x70000, 0x7FFFD), (0x80000, 0x8FFFD), (0x90000, 0x9FFFD),
+	(0xA0000, 0xAFFFD), (0xB0000, 0xBFFFD), (0xC0000, 0xCFFFD),
+	(0xD0000, 0xDFFFD), (0xE0000, 0xEFFFD),
+]
+
+c11_not_start_ranges = [
+	(0x0300, 0x036F),
+	(0x1DC0, 0x1DFF),
+	(0x20D0, 0x20FF),
+	(0xFE20, 0xFE2F),
+]
+
+def in_ranges(cp, ranges):
+	for first, last in ranges:
+		if first <= cp <= last:
+			return True
+	return False
+
+def c11_continue(cp):
+	return in_ranges(cp, c11_continue_ranges)
+
+def c11_start(cp):
+	return c11_continue(cp) and not in_ranges(cp, c11_not_start_ranges)
+
+# C23 rules, XID_Start/XID_Continue (C23 6.4.2.1, Annex D).
+#  str.isidentifier checks XID_Start/XID_Continue directly (no normalization),
+#  so the tables match the unicode version of the python that ran this script.
+
+def is_surrogate(cp):
+	return 0xD800 <= cp <= 0xDFFF
+
+def c23_start(cp):
+	return not is_surrogate(cp) and chr(cp).isidentifier()
+
+def c23_continue(cp):
+	return not is_surrogate(cp) and ('a' + chr(cp)).isidentifier()
+
+def block_bits(pred, i_block):
+	bits = 0
+	for i in range(block_len):
+		cp = i_block * block_len + i
+		if cp >= 0x80 and pred(cp):
+			bits |= 1 << i
+	return bits
+
+def gen_table_set(name, start, cont):
+	blocks = [0]
+	i_from_bits = {0: 0}
+
+	def index_blocks(pred):
+		indices = []
+		for i_block in range(block_count):
+			bits = block_bits(pred, i_block)
+			if bits not in i_from_bits:
+				i_from_bits[bits] = len(blocks)
+				blocks.append(bits)
+			indices.append(i_from_bits[bits])
+		return indices
+
+	i_starts = index_blocks(start)
+	i_continues = index_blocks(cont)
+
+	assert len(blocks) <= 256
+
+	lines = []
+
+	lines.append(f'// {name}')
+	lines.append('')
+	lines.append(f'static const uint64_t id_blocks_{name}[][4] =')
+	lines.append('{')
+	for bits in blocks:
+		words = [(bits >> (64 * i)) & 0xFFFFFFFFFFFFFFFF for i in range(4)]
+		lines.append('\t{ ' + ', '.join(f'0x{w:016X}' for w in words) + ' },')
+	lines.append('};')
+	lines.append('')
+
+	for prop, indices in (('start', i_starts), ('continue', i_continues)):
+		lines.append(f'static const uint8_t id_{prop}_{name}[{block_count}] =')
+		lines.append('{')
+		for i in range(0, block_count, 32):
+			lines.append('\t' + ', '.join(str(x) for x in indices[i:i + 32]) + ',')
+		lines.append('};')
+		lines.append('')
+
+	return lines
+
+def main():
+	lines = []
+	lines.append('// Generated by gen_id_tables.py, do not edit by hand')
+	lines.append(f'//  (C23 tables are from unicode {unicodedata.unidata_version})')
+	lines.append('')
+	lines.append('#pragma once')
+	lines.append('')
+	lines += gen_table_set('c11', c11_start, c11_continue)
+	lines += gen_table_set('c23', c23_start, c23_continue)
+
+	with open(out_path, 'w', newline='\r\n') as out_f:
+		out_f.write('\n'.join(lines) + '\n')
+
+main()
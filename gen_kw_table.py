@@ -0,0 +1,302 @@
+# Generates kw_table.h, the perfect hash Tokk_from_id uses to turn ids into keywords.
+#  Run this from the repo root, and check in the result.
+
+# Keywords (and their dialects) follow clang's TokenKinds.def. Each spelling gets
+#  a mask of Kwd_k dialects it is a keyword in. Aliases (like __inline__) are just
+#  other spellings of the same Tokk_kw_*.
+
+# The hash is 'hash and displace' : FNV-1a of the spelling picks a bucket,
+#  each bucket has a displacement, and (hash ^ displacement) picks the slot.
+#  We search for displacements so every keyword lands in its own slot.
+
+out_path = "kw_table.h"
+
+# Dialects, keep in sync with Kwd_k in ctok.c
+
+C = ['Kwd_c89']								# Every C
+C99 = ['Kwd_c99']							# clang has no C11-only keywords
+C23 = ['Kwd_c23']
+CXX = ['Kwd_cxx']							# Every C++
+CXX11 = ['Kwd_cxx11']
+CXX20 = ['Kwd_cxx20']
+GNU = ['Kwd_gnu']
+MS = ['Kwd_ms']
+OPENCL = ['Kwd_opencl']
+EXT = ['Kwd_ext']							# Altivec, CUDA, HLSL, objc, SYCL, modules
+ALL = C + CXX
+
+BOOL = CXX + C23 + OPENCL
+
+# (spelling, tokk, dialects)
+
+kws = []
+
+def kw(spelling, dialects, tokk=None):
+	kws.append((spelling, tokk or spelling, dialects))
+
+def kws_with(dialects, spellings):
+	for spelling in spellings.split():
+		kw(spelling, dialects)
+
+def alias(spelling, tokk, dialects):
+	kw(spelling, dialects, tokk)
+
+kws_with(ALL, '''
+	auto break case char const continue default do double else enum extern
+	float for goto if int _ExtInt _BitInt long register return short signed
+	sizeof static struct switch typedef union unsigned void volatile while
+	_Alignas _Alignof _Atomic _Complex _Generic _Imaginary _Noreturn
+	_Static_assert _Thread_local __func__ __objc_yes __objc_no''')
+
+kw('_Bool', C)
+kw('asm', CXX + GNU)
+kw('bool', BOOL)
+
+kws_with(CXX, '''
+	catch class const_cast delete dynamic_cast explicit export friend mutable
+	namespace new operator private protected public reinterpret_cast static_cast
+	template this throw try typename typeid using virtual wchar_t''')
+
+kw('false', BOOL)
+kw('true', BOOL)
+kw('restrict', C99)
+kw('inline', C99 + CXX + GNU)
+
+# C23 constexpr is clang 19, clang 17 only has it in C++
+
+kws_with(CXX11 + C23, 'alignas alignof nullptr static_assert thread_local')
+kws_with(CXX11, 'char16_t char32_t constexpr decltype noexcept')
+kws_with(CXX20, 'co_await co_return co_yield consteval constinit concept requires char8_t')
+kws_with(EXT, 'module import')
+
+kw('_Float16', ALL)
+kw('typeof', GNU + C23)
+kw('typeof_unqual', C23)
+kws_with(C, '_Accum _Fract _Sat')
+kws_with(ALL, '_Decimal32 _Decimal64 _Decimal128')
+
+kw('__null', CXX)
+
+kws_with(ALL, '''
+	__alignof __attribute __builtin_choose_expr __builtin_offsetof
+	__builtin_FILE __builtin_FILE_NAME __builtin_FUNCTION __builtin_LINE
+	__builtin_COLUMN __builtin_va_arg __extension__
+	__float128 __ibm128 __imag __int128 __label__ __real __thread __FUNCTION__
+	__PRETTY_FUNCTION__ __auto_type''')
+
+kw('__builtin_types_compatible_p', C)	# KEYNOCXX type trait
+kw('__builtin_FUNCSIG', MS)
+kw('__builtin_source_location', CXX)
+
+kws_with(MS, '__FUNCDNAME__ __FUNCSIG__ L__FUNCTION__ L__FUNCSIG__')
+
+# Type traits
+
+kws_with(MS, '__is_interface_class __is_sealed __is_destructible __is_nothrow_destructible')
+
+kws_with(CXX, '''
+	__is_trivially_destructible __is_nothrow_assignable __is_constructible
+	__is_nothrow_constructible __is_assignable __has_nothrow_move_assign
+	__has_trivial_move_assign __has_trivial_move_constructor __has_nothrow_assign
+	__has_nothrow_copy __has_nothrow_constructor __has_trivial_assign
+	__has_trivial_copy __has_trivial_constructor __has_trivial_destructor
+	__has_virtual_destructor __is_abstract __is_aggregate __is_base_of __is_class
+	__is_convertible_to __is_empty __is_enum __is_final __is_literal __is_pod
+	__is_polymorphic __is_standard_layout __is_trivial __is_trivially_assignable
+	__is_trivially_constructible __is_trivially_copyable __is_union
+	__has_unique_object_representations __add_lvalue_reference __add_pointer
+	__add_rvalue_reference __decay __make_signed __make_unsigned
+	__remove_all_extents __remove_const __remove_cv __remove_cvref
+	__remove_extent __remove_pointer __remove_reference_t __remove_restrict
+	__remove_volatile __underlying_type __is_trivially_relocatable
+	__is_trivially_equality_comparable __is_bounded_array __is_unbounded_array
+	__is_nullptr __is_scoped_enum __is_referenceable __can_pass_in_regs
+	__reference_binds_to_temporary __is_lvalue_expr __is_rvalue_expr
+	__is_arithmetic __is_floating_point __is_integral __is_complete_type
+	__is_void __is_array __is_function __is_reference __is_lvalue_reference
+	__is_rvalue_reference __is_fundamental __is_object __is_scalar
+	__is_compound __is_pointer __is_member_object_pointer
+	__is_member_function_pointer __is_member_pointer __is_const __is_volatile
+	__is_signed __is_unsigned __is_same __is_convertible __array_rank
+	__array_extent''')
+
+kws_with(ALL, '''
+	__private_extern__ __module_private__ __declspec __cdecl __stdcall
+	__fastcall __thiscall __regcall __vectorcall''')
+
+kws_with(MS, '__forceinline __unaligned __super')
+
+# OpenCL
+
+kws_with(OPENCL, '''
+	__global __local __constant __private __generic __kernel __read_only
+	__write_only __read_write __builtin_astype vec_step image1d_t
+	image1d_array_t image1d_buffer_t image2d_t image2d_array_t image2d_depth_t
+	image2d_array_depth_t image2d_msaa_t image2d_array_msaa_t
+	image2d_msaa_depth_t image2d_array_msaa_depth_t image3d_t pipe
+	addrspace_cast''')
+
+kws_with(EXT, '__noinline__ cbuffer tbuffer groupshared')
+kws_with(ALL, '__builtin_omp_required_simd_align __pascal')
+kws_with(EXT, '__vector __pixel __bool')
+kw('__bf16', ALL)
+kw('half', OPENCL)
+kws_with(EXT, '__bridge __bridge_transfer __bridge_retained __bridge_retain')
+
+kws_with(ALL, '''
+	__covariant __contravariant __kindof _Nonnull _Nullable _Nullable_result
+	_Null_unspecified __funcref''')
+
+kws_with(MS, '''
+	__ptr64 __ptr32 __sptr __uptr __w64 __uuidof __try __finally __leave __int64
+	__if_exists __if_not_exists __single_inheritance __multiple_inheritance
+	__virtual_inheritance __interface''')
+
+kws_with(ALL, '__builtin_convertvector __builtin_bit_cast __builtin_available')
+kw('__builtin_sycl_unique_stable_name', EXT)
+kws_with(ALL, '__arm_streaming __unknown_anytype')
+
+# Aliases
+
+alias('__alignof__', '__alignof', ALL)
+alias('__asm', 'asm', ALL)
+alias('__asm__', 'asm', ALL)
+alias('__attribute__', '__attribute', ALL)
+alias('__complex', '_Complex', ALL)
+alias('__complex__', '_Complex', ALL)
+alias('__const', 'const', ALL)
+alias('__const__', 'const', ALL)
+alias('__decltype', 'decltype', CXX)
+alias('__imag__', '__imag', ALL)
+alias('__inline', 'inline', ALL)
+alias('__inline__', 'inline', ALL)
+alias('__nullptr', 'nullptr', CXX)
+alias('__real__', '__real', ALL)
+alias('__restrict', 'restrict', ALL)
+alias('__restrict__', 'restrict', ALL)
+alias('__signed', 'signed', ALL)
+alias('__signed__', 'signed', ALL)
+alias('__typeof', 'typeof', ALL)
+alias('__typeof__', 'typeof', ALL)
+alias('__volatile', 'volatile', ALL)
+alias('__volatile__', 'volatile', ALL)
+alias('__char16_t', 'char16_t', CXX)
+alias('__char32_t', 'char32_t', CXX)
+alias('__is_same_as', '__is_same', CXX)
+
+alias('_alignof', '__alignof', MS)
+alias('__builtin_alignof', '__alignof', MS)
+alias('_asm', 'asm', MS)
+alias('_cdecl', '__cdecl', MS)
+alias('_fastcall', '__fastcall', MS)
+alias('_stdcall', '__stdcall', MS)
+alias('_thiscall', '__thiscall', MS)
+alias('_vectorcall', '__vectorcall', MS)
+alias('_uuidof', '__uuidof', MS)
+alias('_inline', 'inline', MS)
+alias('_declspec', '__declspec', MS)
+alias('__wchar_t', 'wchar_t', MS)
+alias('__int8', 'char', MS)
+alias('__int16', 'short', MS)
+alias('__int32', 'int', MS)
+
+alias('global', '__global', OPENCL)
+alias('local', '__local', OPENCL)
+alias('constant', '__constant', OPENCL)
+alias('private', '__private', OPENCL)
+alias('generic', '__generic', OPENCL)
+alias('kernel', '__kernel', OPENCL)
+alias('read_only', '__read_only', OPENCL)
+alias('write_only', '__write_only', OPENCL)
+alias('read_write', '__read_write', OPENCL)
+
+# Hash, keep in sync with Tokk_from_id in ctok.c
+
+bucket_count = 128
+slot_bits = 10
+slot_count = 1 << slot_bits
+
+def fnv1a(spelling):
+	h = 2166136261
+	for ch in spelling:
+		h ^= ord(ch)
+		h = (h * 16777619) & 0xFFFFFFFF
+	return h
+
+def slot_from_hash(h, disp):
+	return (((h ^ disp) * 0x9E3779B1) & 0xFFFFFFFF) >> (32 - slot_bits)
+
+def main():
+	# 'private' is a c++ keyword and an OpenCL alias for __private.
+	#  OpenCL C is not C++, so the C++ meaning can just win here.
+
+	spellings = {}
+	for spelling, tokk, dialects in kws:
+		if spelling in spellings:
+			assert spelling == 'private', spelling
+			continue
+		spellings[spelling] = (tokk, dialects)
+
+	buckets = [[] for _ in range(bucket_count)]
+	for spelling in spellings:
+		h = fnv1a(spelling)
+		buckets[h % bucket_count].append((spelling, h))
+
+	# Place the biggest buckets first, while there is the most room
+
+	i_kw_from_slot = [0] * slot_count
+	kws_out = []
+	disps = [0] * bucket_count
+
+	for i_bucket in sorted(range(bucket_count), key=lambda i: -len(buckets[i])):
+		bucket = buckets[i_bucket]
+		if not bucket:
+			continue
+
+		for disp in range(1 << 16):
+			slots = [slot_from_hash(h, disp) for _, h in bucket]
+			if len(set(slots)) == len(slots) and all(i_kw_from_slot[s] == 0 for s in slots):
+				break
+		else:
+			assert False, 'no displacement for bucket'
+
+		disps[i_bucket] = disp
+		for (spelling, h), slot in zip(bucket, slots):
+			kws_out.append((spelling, h))
+			i_kw_from_slot[slot] = len(kws_out) # 0 means empty
+
+	lines = []
+	lines.append('// Generated by gen_kw_table.py, do not edit by hand')
+	lines.append('')
+	lines.append('#pragma once')
+	lines.append('')
+	lines.append(f'static const uint32_t kw_bucket_count = {bucket_count};')
+	lines.append(f'static const uint32_t kw_slot_bits = {slot_bits};')
+	lines.append(f'static const uint32_t kw_len_max = {max(len(s) for s in spellings)};')
+	lines.append('')
+	lines.append(f'static const uint16_t kw_disps[{bucket_count}] =')
+	lines.append('{')
+	for i in range(0, bucket_count, 16):
+		lines.append('\t' + ', '.join(str(x) for x in disps[i:i + 16]) + ',')
+	lines.append('};')
+	lines.append('')
+	lines.append('// Index into kws + 1 (0 means empty)')
+	lines.append('')
+	lines.append(f'static const uint16_t kw_i_kw_from_slot[{slot_count}] =')
+	lines.append('{')
+	for i in range(0, slot_count, 16):
+		lines.append('\t' + ', '.join(str(x) for x in i_kw_from_slot[i:i + 16]) + ',')
+	lines.append('};')
+	lines.append('')
+	lines.append(f'static const Kw_t kws[{len(kws_out)}] =')
+	lines.append('{')
+	for spelling, h in kws_out:
+		tokk, dialects = spellings[spelling]
+		mask = ' | '.join(dialects)
+		lines.append(f'\t{{ "{spelling}", {len(spelling)}, 0x{h:08X}, Tokk_kw_{tokk}, {mask} }},')
+	lines.append('};')
+
+	with open(out_path, 'w', newline='\r\n') as out_f:
+		out_f.write('\n'.join(lines) + '\n')
+
+main()
@@ -0,0 +1,451 @@
+// Generated by gen_kw_table.py, do not edit by hand
+
+#pragma once
+
+static const uint32_t kw_bucket_count = 128;
+static const uint32_t kw_slot_bits = 10;
+static const uint32_t kw_len_max = 35;
+
+static const uint16_t kw_disps[128] =
+{
+	0, 0, 0, 0, 2, 1, 0, 0, 0, 1, 2, 8, 0, 0, 0, 0,
+	2, 2, 0, 1, 2, 0, 0, 2, 0, 1, 0, 1, 2, 0, 0, 0,
+	0, 0, 0, 0, 0, 5, 0, 0, 0, 2, 0, 0, 0, 1, 0, 2,
+	0, 0, 0, 0, 0, 0, 1, 2, 0, 1, 0, 0, 3, 0, 1, 0,
+	0, 0, 0, 0, 4, 0, 0, 1, 0, 0, 0, 0, 2, 0, 0, 0,
+	0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 1, 2, 0, 1, 0, 5,
+	1, 0, 0, 6, 0, 0, 0, 1, 3, 2, 0, 1, 0, 0, 1, 0,
+	0, 1, 0, 0, 1, 0, 2, 1, 1, 2, 0, 0, 0, 3, 0, 4,
+};
+
+// Index into kws + 1 (0 means empty)
+
+static const uint16_t kw_i_kw_from_slot[1024] =
+{
+	173, 14, 0, 236, 15, 0, 0, 0, 0, 0, 0, 195, 45, 0, 338, 315,
+	170, 0, 0, 324, 0, 298, 0, 0, 0, 0, 0, 257, 197, 0, 151, 96,
+	0, 126, 183, 0, 0, 90, 0, 0, 119, 0, 0, 312, 0, 352, 0, 0,
+	0, 157, 0, 101, 0, 0, 321, 108, 349, 255, 0, 0, 334, 0, 0, 0,
+	122, 113, 0, 164, 239, 0, 72, 0, 0, 0, 0, 176, 0, 0, 0, 0,
+	0, 0, 0, 0, 275, 0, 0, 0, 0, 175, 0, 0, 253, 0, 33, 279,
+	0, 53, 311, 0, 0, 105, 0, 0, 46, 0, 231, 287, 0, 0, 0, 0,
+	152, 0, 51, 212, 0, 10, 106, 0, 0, 0, 0, 0, 0, 0, 0, 177,
+	128, 0, 0, 0, 187, 0, 233, 136, 0, 0, 0, 0, 0, 125, 0, 327,
+	0, 0, 0, 165, 0, 118, 70, 322, 220, 290, 237, 0, 0, 0, 342, 271,
+	0, 0, 0, 0, 0, 88, 39, 226, 0, 0, 0, 0, 0, 21, 0, 0,
+	341, 0, 0, 214, 95, 2, 0, 259, 17, 49, 0, 0, 0, 0, 97, 0,
+	0, 0, 286, 0, 0, 297, 0, 0, 121, 0, 0, 154, 270, 0, 0, 0,
+	0, 117, 37, 0, 0, 155, 0, 28, 0, 188, 0, 0, 0, 0, 0, 0,
+	13, 0, 0, 0, 123, 142, 0, 0, 0, 0, 0, 316, 0, 0, 0, 0,
+	0, 0, 0, 135, 50, 0, 0, 346, 0, 191, 356, 0, 293, 0, 186, 314,
+	0, 246, 323, 0, 0, 0, 0, 0, 0, 0, 0, 0, 100, 0, 0, 40,
+	139, 0, 0, 0, 304, 0, 0, 204, 0, 0, 326, 58, 291, 189, 0, 0,
+	196, 143, 288, 0, 56, 91, 0, 303, 0, 0, 0, 0, 92, 0, 0, 0,
+	0, 0, 18, 0, 0, 103, 0, 0, 294, 0, 168, 156, 0, 0, 0, 0,
+	208, 77, 0, 0, 0, 0, 26, 0, 0, 55, 0, 0, 0, 0, 232, 0,
+	0, 0, 0, 0, 0, 54, 32, 0, 0, 0, 0, 0, 0, 16, 0, 0,
+	0, 242, 0, 0, 44, 0, 0, 0, 78, 0, 107, 0, 0, 313, 0, 0,
+	0, 162, 0, 52, 0, 0, 283, 61, 0, 0, 0, 0, 0, 0, 203, 0,
+	0, 0, 0, 224, 0, 67, 0, 0, 20, 0, 0, 0, 260, 0, 89, 249,
+	0, 248, 29, 0, 0, 0, 124, 0, 48, 0, 336, 0, 0, 27, 0, 0,
+	0, 0, 0, 329, 0, 347, 138, 0, 86, 0, 0, 0, 0, 0, 209, 0,
+	0, 0, 0, 0, 295, 306, 296, 0, 0, 87, 0, 0, 180, 0, 206, 0,
+	0, 0, 0, 178, 0, 163, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 19, 0, 60, 0, 0, 0, 0, 0, 280, 0,
+	0, 65, 0, 116, 0, 0, 0, 0, 0, 0, 0, 83, 0, 0, 0, 0,
+	0, 0, 3, 129, 104, 0, 234, 0, 0, 159, 134, 245, 0, 0, 198, 344,
+	247, 0, 0, 0, 25, 0, 63, 0, 0, 307, 0, 11, 0, 0, 0, 241,
+	0, 261, 0, 35, 0, 23, 0, 0, 0, 278, 0, 0, 305, 276, 82, 0,
+	0, 0, 0, 0, 0, 0, 133, 0, 0, 0, 0, 0, 317, 0, 98, 0,
+	0, 84, 0, 0, 0, 146, 0, 0, 284, 0, 115, 0, 184, 221, 0, 43,
+	319, 0, 0, 144, 0, 0, 282, 0, 0, 0, 0, 149, 228, 274, 333, 0,
+	0, 0, 62, 337, 0, 0, 211, 264, 0, 76, 272, 0, 0, 0, 252, 0,
+	81, 171, 0, 0, 262, 0, 0, 190, 31, 0, 0, 0, 1, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 351, 0, 0, 0, 160, 0, 0, 348, 332, 0,
+	0, 199, 0, 0, 0, 0, 0, 309, 112, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 301, 80, 0, 0, 0, 0, 0, 0, 102, 0, 0,
+	0, 0, 0, 0, 0, 0, 205, 0, 137, 0, 0, 0, 94, 59, 0, 318,
+	0, 0, 0, 219, 0, 192, 57, 0, 299, 47, 30, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 66, 0, 230, 0, 0, 145, 0, 243, 0, 0, 0,
+	340, 0, 0, 0, 0, 127, 0, 0, 0, 0, 0, 266, 0, 111, 0, 0,
+	251, 0, 0, 120, 0, 0, 0, 258, 24, 0, 335, 0, 0, 0, 0, 0,
+	0, 225, 0, 0, 5, 267, 0, 85, 0, 254, 0, 0, 0, 174, 0, 0,
+	0, 0, 0, 148, 0, 0, 0, 0, 114, 0, 0, 223, 0, 0, 0, 150,
+	34, 0, 0, 0, 0, 194, 0, 207, 215, 79, 0, 141, 0, 0, 200, 0,
+	320, 0, 0, 0, 350, 268, 0, 217, 353, 0, 289, 0, 0, 0, 0, 161,
+	0, 181, 0, 68, 75, 0, 0, 0, 0, 0, 0, 269, 0, 0, 158, 238,
+	0, 0, 0, 0, 0, 0, 0, 273, 0, 0, 0, 0, 0, 110, 0, 0,
+	0, 172, 201, 0, 6, 0, 0, 0, 0, 0, 358, 22, 0, 256, 0, 0,
+	292, 0, 0, 0, 0, 169, 0, 0, 300, 229, 235, 0, 0, 64, 0, 0,
+	0, 0, 0, 328, 0, 42, 36, 0, 0, 0, 0, 140, 0, 0, 355, 185,
+	339, 0, 0, 0, 0, 109, 0, 0, 0, 0, 265, 281, 0, 0, 285, 0,
+	0, 0, 325, 0, 213, 166, 0, 0, 7, 0, 263, 202, 0, 153, 0, 0,
+	0, 0, 0, 0, 12, 71, 0, 0, 167, 0, 0, 0, 0, 0, 210, 9,
+	0, 99, 0, 0, 343, 218, 216, 0, 73, 0, 0, 147, 0, 0, 69, 308,
+	310, 0, 0, 0, 38, 222, 0, 331, 345, 250, 227, 0, 0, 0, 0, 240,
+	0, 132, 0, 0, 0, 0, 74, 0, 0, 0, 354, 0, 0, 330, 0, 0,
+	0, 4, 193, 179, 277, 0, 0, 130, 0, 182, 302, 0, 0, 0, 0, 0,
+	93, 8, 0, 0, 0, 0, 0, 0, 0, 244, 357, 0, 131, 0, 0, 41,
+};
+
+static const Kw_t kws[358] =
+{
+	{ "default", 7, 0x933B5BDE, Tokk_kw_default, Kwd_c89 | Kwd_cxx },
+	{ "int", 3, 0x95E97E5E, Tokk_kw_int, Kwd_c89 | Kwd_cxx },
+	{ "_Complex", 8, 0x18338D5E, Tokk_kw__Complex, Kwd_c89 | Kwd_cxx },
+	{ "static_assert", 13, 0xFB9673DE, Tokk_kw_static_assert, Kwd_cxx11 | Kwd_c23 },
+	{ "co_return", 9, 0xD27D73DE, Tokk_kw_co_return, Kwd_cxx20 },
+	{ "__has_trivial_move_constructor", 30, 0x1650BFDE, Tokk_kw___has_trivial_move_constructor, Kwd_cxx },
+	{ "__bridge_retain", 15, 0x9B5E455E, Tokk_kw___bridge_retain, Kwd_ext },
+	{ "__funcref", 9, 0xB42013DE, Tokk_kw___funcref, Kwd_c89 | Kwd_cxx },
+	{ "__unknown_anytype", 17, 0x3CC1ADDE, Tokk_kw___unknown_anytype, Kwd_c89 | Kwd_cxx },
+	{ "struct", 6, 0x92C2BE20, Tokk_kw_struct, Kwd_c89 | Kwd_cxx },
+	{ "asm", 3, 0x1472C0A0, Tokk_kw_asm, Kwd_cxx | Kwd_gnu },
+	{ "namespace", 9, 0xCACE7AA0, Tokk_kw_namespace, Kwd_cxx },
+	{ "typeof", 6, 0x9A90A8A0, Tokk_kw_typeof, Kwd_gnu | Kwd_c23 },
+	{ "__has_unique_object_representations", 35, 0xBF939520, Tokk_kw___has_unique_object_representations, Kwd_cxx },
+	{ "__is_function", 13, 0x081972A0, Tokk_kw___is_function, Kwd_cxx },
+	{ "__single_inheritance", 20, 0x8D48F8A0, Tokk_kw___single_inheritance, Kwd_ms },
+	{ "__nullptr", 9, 0xAD6C2720, Tokk_kw_nullptr, Kwd_cxx },
+	{ "volatile", 8, 0x94E1036D, Tokk_kw_volatile, Kwd_c89 | Kwd_cxx },
+	{ "char16_t", 8, 0x801A266D, Tokk_kw_char16_t, Kwd_cxx11 },
+	{ "__imag", 6, 0x338BB2ED, Tokk_kw___imag, Kwd_c89 | Kwd_cxx },
+	{ "__has_virtual_destructor", 24, 0x55DE966D, Tokk_kw___has_virtual_destructor, Kwd_cxx },
+	{ "__remove_all_extents", 20, 0x057BB6ED, Tokk_kw___remove_all_extents, Kwd_cxx },
+	{ "__can_pass_in_regs", 18, 0xEEE168ED, Tokk_kw___can_pass_in_regs, Kwd_cxx },
+	{ "__if_exists", 11, 0x73D99BED, Tokk_kw___if_exists, Kwd_ms },
+	{ "__virtual_inheritance", 21, 0x7570786D, Tokk_kw___virtual_inheritance, Kwd_ms },
+	{ "__objc_no", 9, 0x90235919, Tokk_kw___objc_no, Kwd_c89 | Kwd_cxx },
+	{ "__alignof", 9, 0x9767CC19, Tokk_kw___alignof, Kwd_c89 | Kwd_cxx },
+	{ "__has_trivial_assign", 20, 0xB80AA819, Tokk_kw___has_trivial_assign, Kwd_cxx },
+	{ "__is_empty", 10, 0x0A8F6419, Tokk_kw___is_empty, Kwd_cxx },
+	{ "__is_nullptr", 12, 0x27C0D299, Tokk_kw___is_nullptr, Kwd_cxx },
+	{ "__is_pointer", 12, 0x80022B19, Tokk_kw___is_pointer, Kwd_cxx },
+	{ "__array_extent", 14, 0x6F41CF19, Tokk_kw___array_extent, Kwd_cxx },
+	{ "while", 5, 0x0DC628CE, Tokk_kw_while, Kwd_c89 | Kwd_cxx },
+	{ "typename", 8, 0x19A9984E, Tokk_kw_typename, Kwd_cxx },
+	{ "_Decimal128", 11, 0x157EB3CE, Tokk_kw__Decimal128, Kwd_c89 | Kwd_cxx },
+	{ "__is_abstract", 13, 0xD28E93CE, Tokk_kw___is_abstract, Kwd_cxx },
+	{ "__super", 7, 0x6C05094E, Tokk_kw___super, Kwd_ms },
+	{ "__private", 9, 0x98FB3DCE, Tokk_kw___private, Kwd_opencl },
+	{ "__typeof", 8, 0x6D9D57CE, Tokk_kw_typeof, Kwd_c89 | Kwd_cxx },
+	{ "typeid", 6, 0xA8953BD8, Tokk_kw_typeid, Kwd_cxx },
+	{ "false", 5, 0x0B069958, Tokk_kw_false, Kwd_cxx | Kwd_c23 | Kwd_opencl },
+	{ "__builtin_source_location", 25, 0x7B9894D8, Tokk_kw___builtin_source_location, Kwd_cxx },
+	{ "__stdcall", 9, 0xA4A6F458, Tokk_kw___stdcall, Kwd_c89 | Kwd_cxx },
+	{ "__global", 8, 0x418B6ED8, Tokk_kw___global, Kwd_opencl },
+	{ "kernel", 6, 0x229E4ED8, Tokk_kw___kernel, Kwd_opencl },
+	{ "read_only", 9, 0x479977D8, Tokk_kw___read_only, Kwd_opencl },
+	{ "_Imaginary", 10, 0xE3F06707, Tokk_kw__Imaginary, Kwd_c89 | Kwd_cxx },
+	{ "__func__", 8, 0xDF9EDC87, Tokk_kw___func__, Kwd_c89 | Kwd_cxx },
+	{ "using", 5, 0x69CE1407, Tokk_kw_using, Kwd_cxx },
+	{ "__has_trivial_move_assign", 25, 0xF3CB6C07, Tokk_kw___has_trivial_move_assign, Kwd_cxx },
+	{ "__has_trivial_destructor", 24, 0xC6F6E687, Tokk_kw___has_trivial_destructor, Kwd_cxx },
+	{ "_stdcall", 8, 0x1FACE607, Tokk_kw___stdcall, Kwd_ms },
+	{ "alignas", 7, 0xEC3C3C7A, Tokk_kw_alignas, Kwd_cxx11 | Kwd_c23 },
+	{ "_Fract", 6, 0x0EF3F87A, Tokk_kw__Fract, Kwd_c89 },
+	{ "__builtin_FUNCSIG", 17, 0xC7D0DB7A, Tokk_kw___builtin_FUNCSIG, Kwd_ms },
+	{ "addrspace_cast", 14, 0xFDA2457A, Tokk_kw_addrspace_cast, Kwd_opencl },
+	{ "_thiscall", 9, 0x04C9CFFA, Tokk_kw___thiscall, Kwd_ms },
+	{ "generic", 7, 0x51CCEFFA, Tokk_kw___generic, Kwd_opencl },
+	{ "enum", 4, 0x816CB000, Tokk_kw_enum, Kwd_c89 | Kwd_cxx },
+	{ "public", 6, 0xCC909380, Tokk_kw_public, Kwd_cxx },
+	{ "__is_trivially_constructible", 28, 0xC4EDE300, Tokk_kw___is_trivially_constructible, Kwd_cxx },
+	{ "__vectorcall", 12, 0xDB458780, Tokk_kw___vectorcall, Kwd_c89 | Kwd_cxx },
+	{ "__builtin_bit_cast", 18, 0xF82E8200, Tokk_kw___builtin_bit_cast, Kwd_c89 | Kwd_cxx },
+	{ "char", 4, 0xA84C031D, Tokk_kw_char, Kwd_c89 | Kwd_cxx },
+	{ "module", 6, 0xD79F909D, Tokk_kw_module, Kwd_ext },
+	{ "__builtin_LINE", 14, 0x2228B09D, Tokk_kw___builtin_LINE, Kwd_c89 | Kwd_cxx },
+	{ "__is_trivially_destructible", 27, 0x45B3519D, Tokk_kw___is_trivially_destructible, Kwd_cxx },
+	{ "__ptr64", 7, 0xCE346D9D, Tokk_kw___ptr64, Kwd_ms },
+	{ "alignof", 7, 0xC919731F, Tokk_kw_alignof, Kwd_cxx11 | Kwd_c23 },
+	{ "_Decimal64", 10, 0x5EFE871F, Tokk_kw__Decimal64, Kwd_c89 | Kwd_cxx },
+	{ "__builtin_FUNCTION", 18, 0x5936B69F, Tokk_kw___builtin_FUNCTION, Kwd_c89 | Kwd_cxx },
+	{ "image2d_t", 9, 0xFF10659F, Tokk_kw_image2d_t, Kwd_opencl },
+	{ "__if_not_exists", 15, 0x1268A11F, Tokk_kw___if_not_exists, Kwd_ms },
+	{ "__FUNCDNAME__", 13, 0x8A82EF2A, Tokk_kw___FUNCDNAME__, Kwd_ms },
+	{ "L__FUNCSIG__", 12, 0x887A492A, Tokk_kw_L__FUNCSIG__, Kwd_ms },
+	{ "__kernel", 8, 0x75EC152A, Tokk_kw___kernel, Kwd_opencl },
+	{ "__sptr", 6, 0x6523652A, Tokk_kw___sptr, Kwd_ms },
+	{ "__builtin_sycl_unique_stable_name", 33, 0xA4B981AA, Tokk_kw___builtin_sycl_unique_stable_name, Kwd_ext },
+	{ "__objc_yes", 10, 0xAAA86D35, Tokk_kw___objc_yes, Kwd_c89 | Kwd_cxx },
+	{ "__is_convertible_to", 19, 0xE32A40B5, Tokk_kw___is_convertible_to, Kwd_cxx },
+	{ "__is_array", 10, 0x1D40C3B5, Tokk_kw___is_array, Kwd_cxx },
+	{ "_Nullable_result", 16, 0xFB551FB5, Tokk_kw__Nullable_result, Kwd_c89 | Kwd_cxx },
+	{ "__builtin_alignof", 17, 0xE39D4AB5, Tokk_kw___alignof, Kwd_ms },
+	{ "_Decimal32", 10, 0xEB061F48, Tokk_kw__Decimal32, Kwd_c89 | Kwd_cxx },
+	{ "__is_sealed", 11, 0xB81329C8, Tokk_kw___is_sealed, Kwd_ms },
+	{ "__has_nothrow_constructor", 25, 0x7C6856C8, Tokk_kw___has_nothrow_constructor, Kwd_cxx },
+	{ "__is_polymorphic", 16, 0x47610848, Tokk_kw___is_polymorphic, Kwd_cxx },
+	{ "__unaligned", 11, 0xF12F23C8, Tokk_kw___unaligned, Kwd_ms },
+	{ "__builtin_FILE", 14, 0xF135C751, Tokk_kw___builtin_FILE, Kwd_c89 | Kwd_cxx },
+	{ "__is_member_function_pointer", 28, 0x42FE7951, Tokk_kw___is_member_function_pointer, Kwd_cxx },
+	{ "image2d_array_t", 15, 0x03E87151, Tokk_kw_image2d_array_t, Kwd_opencl },
+	{ "__uuidof", 8, 0x7DAC8DD1, Tokk_kw___uuidof, Kwd_ms },
+	{ "__complex", 9, 0x869C8051, Tokk_kw__Complex, Kwd_c89 | Kwd_cxx },
+	{ "__is_bounded_array", 18, 0xC96D5E6B, Tokk_kw___is_bounded_array, Kwd_cxx },
+	{ "__is_convertible", 16, 0x42B332EB, Tokk_kw___is_convertible, Kwd_cxx },
+	{ "__forceinline", 13, 0x3D4A0A6B, Tokk_kw___forceinline, Kwd_ms },
+	{ "__builtin_omp_required_simd_align", 33, 0xEDA4576B, Tokk_kw___builtin_omp_required_simd_align, Kwd_c89 | Kwd_cxx },
+	{ "_inline", 7, 0xDB26516B, Tokk_kw_inline, Kwd_ms },
+	{ "switch", 6, 0x93E05F71, Tokk_kw_switch, Kwd_c89 | Kwd_cxx },
+	{ "wchar_t", 7, 0xC523B9F1, Tokk_kw_wchar_t, Kwd_cxx },
+	{ "__FUNCTION__", 12, 0xE3638571, Tokk_kw___FUNCTION__, Kwd_c89 | Kwd_cxx },
+	{ "__remove_pointer", 16, 0x472F3C71, Tokk_kw___remove_pointer, Kwd_cxx },
+	{ "__builtin_convertvector", 23, 0x8DFB82F1, Tokk_kw___builtin_convertvector, Kwd_c89 | Kwd_cxx },
+	{ "private", 7, 0x62CB0D0C, Tokk_kw_private, Kwd_cxx },
+	{ "__builtin_choose_expr", 21, 0x1B3A508C, Tokk_kw___builtin_choose_expr, Kwd_c89 | Kwd_cxx },
+	{ "__FUNCSIG__", 11, 0x48116E0C, Tokk_kw___FUNCSIG__, Kwd_ms },
+	{ "__is_volatile", 13, 0xCA348D0C, Tokk_kw___is_volatile, Kwd_cxx },
+	{ "for", 3, 0xACF38390, Tokk_kw_for, Kwd_c89 | Kwd_cxx },
+	{ "__is_scoped_enum", 16, 0xCAB25E90, Tokk_kw___is_scoped_enum, Kwd_cxx },
+	{ "image2d_array_msaa_depth_t", 26, 0xE5279790, Tokk_kw_image2d_array_msaa_depth_t, Kwd_opencl },
+	{ "__inline__", 10, 0xA9597A10, Tokk_kw_inline, Kwd_c89 | Kwd_cxx },
+	{ "new", 3, 0x28999611, Tokk_kw_new, Kwd_cxx },
+	{ "__builtin_FILE_NAME", 19, 0xA68DBB11, Tokk_kw___builtin_FILE_NAME, Kwd_c89 | Kwd_cxx },
+	{ "__builtin_va_arg", 16, 0x32A74591, Tokk_kw___builtin_va_arg, Kwd_c89 | Kwd_cxx },
+	{ "__fastcall", 10, 0xBD4B7111, Tokk_kw___fastcall, Kwd_c89 | Kwd_cxx },
+	{ "do", 2, 0x621CD814, Tokk_kw_do, Kwd_c89 | Kwd_cxx },
+	{ "__ibm128", 8, 0xFC0F3894, Tokk_kw___ibm128, Kwd_c89 | Kwd_cxx },
+	{ "__multiple_inheritance", 22, 0xFDB32C14, Tokk_kw___multiple_inheritance, Kwd_ms },
+	{ "__typeof__", 10, 0xFF65C714, Tokk_kw_typeof, Kwd_c89 | Kwd_cxx },
+	{ "_Alignas", 8, 0x6AA4A81B, Tokk_kw__Alignas, Kwd_c89 | Kwd_cxx },
+	{ "_Float16", 8, 0x8465F89B, Tokk_kw__Float16, Kwd_c89 | Kwd_cxx },
+	{ "__is_floating_point", 19, 0x548BE61B, Tokk_kw___is_floating_point, Kwd_cxx },
+	{ "_Nullable", 9, 0x42E6A71B, Tokk_kw__Nullable, Kwd_c89 | Kwd_cxx },
+	{ "thread_local", 12, 0xCD3C1AA1, Tokk_kw_thread_local, Kwd_cxx11 | Kwd_c23 },
+	{ "__reference_binds_to_temporary", 30, 0x1B49D621, Tokk_kw___reference_binds_to_temporary, Kwd_cxx },
+	{ "image1d_buffer_t", 16, 0x2F30DF21, Tokk_kw_image1d_buffer_t, Kwd_opencl },
+	{ "__restrict__", 12, 0xF465E9A1, Tokk_kw_restrict, Kwd_c89 | Kwd_cxx },
+	{ "typedef", 7, 0x221EDE24, Tokk_kw_typedef, Kwd_c89 | Kwd_cxx },
+	{ "__bf16", 6, 0x9926BF24, Tokk_kw___bf16, Kwd_c89 | Kwd_cxx },
+	{ "half", 4, 0xD6BEC8A4, Tokk_kw_half, Kwd_opencl },
+	{ "_fastcall", 9, 0xE95B1DA4, Tokk_kw___fastcall, Kwd_ms },
+	{ "mutable", 7, 0x3B0333A9, Tokk_kw_mutable, Kwd_cxx },
+	{ "__make_unsigned", 15, 0x236061A9, Tokk_kw___make_unsigned, Kwd_cxx },
+	{ "_vectorcall", 11, 0x01F9A5A9, Tokk_kw___vectorcall, Kwd_ms },
+	{ "read_write", 10, 0x4F881DA9, Tokk_kw___read_write, Kwd_opencl },
+	{ "__thread", 8, 0xBFB0322B, Tokk_kw___thread, Kwd_c89 | Kwd_cxx },
+	{ "__is_aggregate", 14, 0x5B00822B, Tokk_kw___is_aggregate, Kwd_cxx },
+	{ "__thiscall", 10, 0x63A855AB, Tokk_kw___thiscall, Kwd_c89 | Kwd_cxx },
+	{ "__volatile", 10, 0xA2440FAB, Tokk_kw_volatile, Kwd_c89 | Kwd_cxx },
+	{ "_Generic", 8, 0x10D4792F, Tokk_kw__Generic, Kwd_c89 | Kwd_cxx },
+	{ "throw", 5, 0x7A78762F, Tokk_kw_throw, Kwd_cxx },
+	{ "__is_union", 10, 0x3603032F, Tokk_kw___is_union, Kwd_cxx },
+	{ "__is_object", 11, 0xE44F46AF, Tokk_kw___is_object, Kwd_cxx },
+	{ "__remove_reference_t", 20, 0xA07FF646, Tokk_kw___remove_reference_t, Kwd_cxx },
+	{ "__is_unbounded_array", 20, 0xF087DF46, Tokk_kw___is_unbounded_array, Kwd_cxx },
+	{ "image1d_array_t", 15, 0xA0D69846, Tokk_kw_image1d_array_t, Kwd_opencl },
+	{ "__asm", 5, 0x039438C6, Tokk_kw_asm, Kwd_c89 | Kwd_cxx },
+	{ "__is_rvalue_expr", 16, 0x15B5C1C7, Tokk_kw___is_rvalue_expr, Kwd_cxx },
+	{ "__constant", 10, 0xD7020CC7, Tokk_kw___constant, Kwd_opencl },
+	{ "__attribute__", 13, 0x1E781F47, Tokk_kw___attribute, Kwd_c89 | Kwd_cxx },
+	{ "__is_same_as", 12, 0xFA1F94C7, Tokk_kw___is_same, Kwd_cxx },
+	{ "_BitInt", 7, 0x366B1CCA, Tokk_kw__BitInt, Kwd_c89 | Kwd_cxx },
+	{ "delete", 6, 0x67C2444A, Tokk_kw_delete, Kwd_cxx },
+	{ "__add_rvalue_reference", 22, 0x5D27E54A, Tokk_kw___add_rvalue_reference, Kwd_cxx },
+	{ "__read_only", 11, 0x2953A04A, Tokk_kw___read_only, Kwd_opencl },
+	{ "dynamic_cast", 12, 0x676A80DC, Tokk_kw_dynamic_cast, Kwd_cxx },
+	{ "__is_member_pointer", 19, 0xE4BFA55C, Tokk_kw___is_member_pointer, Kwd_cxx },
+	{ "cbuffer", 7, 0x022B61DC, Tokk_kw_cbuffer, Kwd_ext },
+	{ "__int8", 6, 0x96F927DC, Tokk_kw_char, Kwd_ms },
+	{ "__decay", 7, 0xDDF71763, Tokk_kw___decay, Kwd_cxx },
+	{ "__private_extern__", 18, 0x85BFE563, Tokk_kw___private_extern__, Kwd_c89 | Kwd_cxx },
+	{ "image2d_array_depth_t", 21, 0x3B055263, Tokk_kw_image2d_array_depth_t, Kwd_opencl },
+	{ "__wchar_t", 9, 0x3423A3E3, Tokk_kw_wchar_t, Kwd_ms },
+	{ "true", 4, 0x4DB211E5, Tokk_kw_true, Kwd_cxx | Kwd_c23 | Kwd_opencl },
+	{ "restrict", 8, 0xFDD57AE5, Tokk_kw_restrict, Kwd_c99 },
+	{ "__is_constructible", 18, 0x263B9965, Tokk_kw___is_constructible, Kwd_cxx },
+	{ "__is_referenceable", 18, 0x271383E5, Tokk_kw___is_referenceable, Kwd_cxx },
+	{ "__add_lvalue_reference", 22, 0x993C4B6C, Tokk_kw___add_lvalue_reference, Kwd_cxx },
+	{ "__is_trivially_equality_comparable", 34, 0xC93EB76C, Tokk_kw___is_trivially_equality_comparable, Kwd_cxx },
+	{ "__generic", 9, 0x93C74A6C, Tokk_kw___generic, Kwd_opencl },
+	{ "__arm_streaming", 15, 0xAC96A96C, Tokk_kw___arm_streaming, Kwd_c89 | Kwd_cxx },
+	{ "__builtin_offsetof", 18, 0xDCEC13F5, Tokk_kw___builtin_offsetof, Kwd_c89 | Kwd_cxx },
+	{ "__int128", 8, 0x937657F5, Tokk_kw___int128, Kwd_c89 | Kwd_cxx },
+	{ "__is_enum", 9, 0x4413BF75, Tokk_kw___is_enum, Kwd_cxx },
+	{ "__char32_t", 10, 0x7B2F1DF5, Tokk_kw_char32_t, Kwd_cxx },
+	{ "_ExtInt", 7, 0x83AF6D76, Tokk_kw__ExtInt, Kwd_c89 | Kwd_cxx },
+	{ "constinit", 9, 0xF6522276, Tokk_kw_constinit, Kwd_cxx20 },
+	{ "__PRETTY_FUNCTION__", 19, 0x023E3BF6, Tokk_kw___PRETTY_FUNCTION__, Kwd_c89 | Kwd_cxx },
+	{ "image2d_msaa_depth_t", 20, 0xDEF6F8F6, Tokk_kw_image2d_msaa_depth_t, Kwd_opencl },
+	{ "__is_assignable", 15, 0x5C852379, Tokk_kw___is_assignable, Kwd_cxx },
+	{ "pipe", 4, 0xF81D19F9, Tokk_kw_pipe, Kwd_opencl },
+	{ "tbuffer", 7, 0x7600D679, Tokk_kw_tbuffer, Kwd_ext },
+	{ "__volatile__", 12, 0x7C6D1079, Tokk_kw_volatile, Kwd_c89 | Kwd_cxx },
+	{ "sizeof", 6, 0x6EE13AFD, Tokk_kw_sizeof, Kwd_c89 | Kwd_cxx },
+	{ "operator", 8, 0xFBD4EEFD, Tokk_kw_operator, Kwd_cxx },
+	{ "protected", 9, 0x1E54727D, Tokk_kw_protected, Kwd_cxx },
+	{ "__is_trivially_relocatable", 26, 0x10A736FD, Tokk_kw___is_trivially_relocatable, Kwd_cxx },
+	{ "class", 5, 0xAB3E0BFF, Tokk_kw_class, Kwd_cxx },
+	{ "__real", 6, 0xC54664FF, Tokk_kw___real, Kwd_c89 | Kwd_cxx },
+	{ "__is_fundamental", 16, 0x543554FF, Tokk_kw___is_fundamental, Kwd_cxx },
+	{ "__regcall", 9, 0x4650C5FF, Tokk_kw___regcall, Kwd_c89 | Kwd_cxx },
+	{ "float", 5, 0xA6C45D85, Tokk_kw_float, Kwd_c89 | Kwd_cxx },
+	{ "__has_trivial_copy", 18, 0xD813C705, Tokk_kw___has_trivial_copy, Kwd_cxx },
+	{ "__write_only", 12, 0xC434BD85, Tokk_kw___write_only, Kwd_opencl },
+	{ "friend", 6, 0xCBA09F8D, Tokk_kw_friend, Kwd_cxx },
+	{ "__auto_type", 11, 0x572B7B0D, Tokk_kw___auto_type, Kwd_c89 | Kwd_cxx },
+	{ "image2d_depth_t", 15, 0x8C7F1F8D, Tokk_kw_image2d_depth_t, Kwd_opencl },
+	{ "try", 3, 0xAC1DB00E, Tokk_kw_try, Kwd_cxx },
+	{ "__covariant", 11, 0xB1DFD70E, Tokk_kw___covariant, Kwd_c89 | Kwd_cxx },
+	{ "__int64", 7, 0x9648E30E, Tokk_kw___int64, Kwd_ms },
+	{ "co_await", 8, 0xD34FD592, Tokk_kw_co_await, Kwd_cxx20 },
+	{ "_Sat", 4, 0x38EAFD12, Tokk_kw__Sat, Kwd_c89 },
+	{ "__finally", 9, 0x37971492, Tokk_kw___finally, Kwd_ms },
+	{ "char32_t", 8, 0xA846FC93, Tokk_kw_char32_t, Kwd_cxx11 },
+	{ "concept", 7, 0xA3383D13, Tokk_kw_concept, Kwd_cxx20 },
+	{ "__restrict", 10, 0x86008D93, Tokk_kw_restrict, Kwd_c89 | Kwd_cxx },
+	{ "signed", 6, 0xB5712015, Tokk_kw_signed, Kwd_c89 | Kwd_cxx },
+	{ "reinterpret_cast", 16, 0x13251E95, Tokk_kw_reinterpret_cast, Kwd_cxx },
+	{ "__is_compound", 13, 0x10671915, Tokk_kw___is_compound, Kwd_cxx },
+	{ "auto", 4, 0x923FA396, Tokk_kw_auto, Kwd_c89 | Kwd_cxx },
+	{ "__null", 6, 0x8D72F616, Tokk_kw___null, Kwd_cxx },
+	{ "__is_destructible", 17, 0x6C9BAB96, Tokk_kw___is_destructible, Kwd_ms },
+	{ "__cdecl", 7, 0x60A18C9C, Tokk_kw___cdecl, Kwd_c89 | Kwd_cxx },
+	{ "vec_step", 8, 0x02E08E1C, Tokk_kw_vec_step, Kwd_opencl },
+	{ "__uptr", 6, 0x4D63201C, Tokk_kw___uptr, Kwd_ms },
+	{ "static_cast", 11, 0xA7226423, Tokk_kw_static_cast, Kwd_cxx },
+	{ "__is_pod", 8, 0x69C6B623, Tokk_kw___is_pod, Kwd_cxx },
+	{ "__int16", 7, 0x06504F23, Tokk_kw_short, Kwd_ms },
+	{ "decltype", 8, 0xBEF43EA5, Tokk_kw_decltype, Kwd_cxx11 },
+	{ "__underlying_type", 17, 0x1F5E8725, Tokk_kw___underlying_type, Kwd_cxx },
+	{ "constant", 8, 0x0691EA25, Tokk_kw___constant, Kwd_opencl },
+	{ "__builtin_COLUMN", 16, 0x5253E9AD, Tokk_kw___builtin_COLUMN, Kwd_c89 | Kwd_cxx },
+	{ "__has_nothrow_assign", 20, 0x87E480AD, Tokk_kw___has_nothrow_assign, Kwd_cxx },
+	{ "__real__", 8, 0xDE1351AD, Tokk_kw___real, Kwd_c89 | Kwd_cxx },
+	{ "_Alignof", 8, 0x4D81E832, Tokk_kw__Alignof, Kwd_c89 | Kwd_cxx },
+	{ "__is_void", 9, 0x7194A0B2, Tokk_kw___is_void, Kwd_cxx },
+	{ "__ptr32", 7, 0x3E3BD9B2, Tokk_kw___ptr32, Kwd_ms },
+	{ "export", 6, 0xFB080CB3, Tokk_kw_export, Kwd_cxx },
+	{ "__char16_t", 10, 0xBE1CB733, Tokk_kw_char16_t, Kwd_cxx },
+	{ "write_only", 10, 0xAE195333, Tokk_kw___write_only, Kwd_opencl },
+	{ "inline", 6, 0xC2CB5034, Tokk_kw_inline, Kwd_c99 | Kwd_cxx | Kwd_gnu },
+	{ "__try", 5, 0x023948B4, Tokk_kw___try, Kwd_ms },
+	{ "__const__", 9, 0xC53ADEB4, Tokk_kw_const, Kwd_c89 | Kwd_cxx },
+	{ "extern", 6, 0x9087DDB7, Tokk_kw_extern, Kwd_c89 | Kwd_cxx },
+	{ "_Atomic", 7, 0xFF2BDAB7, Tokk_kw__Atomic, Kwd_c89 | Kwd_cxx },
+	{ "__decltype", 10, 0xA52EE3B7, Tokk_kw_decltype, Kwd_cxx },
+	{ "static", 6, 0xD290C23B, Tokk_kw_static, Kwd_c89 | Kwd_cxx },
+	{ "__pascal", 8, 0xA175BABB, Tokk_kw___pascal, Kwd_c89 | Kwd_cxx },
+	{ "__contravariant", 15, 0xCC44C7BB, Tokk_kw___contravariant, Kwd_c89 | Kwd_cxx },
+	{ "virtual", 7, 0x5D967EBC, Tokk_kw_virtual, Kwd_cxx },
+	{ "char8_t", 7, 0x5807E43C, Tokk_kw_char8_t, Kwd_cxx20 },
+	{ "__kindof", 8, 0xA1E63FBC, Tokk_kw___kindof, Kwd_c89 | Kwd_cxx },
+	{ "register", 8, 0x2D6871C0, Tokk_kw_register, Kwd_c89 | Kwd_cxx },
+	{ "__builtin_types_compatible_p", 28, 0xA90990C0, Tokk_kw___builtin_types_compatible_p, Kwd_c89 },
+	{ "__is_final", 10, 0x3F02DFC0, Tokk_kw___is_final, Kwd_cxx },
+	{ "explicit", 8, 0x68E79149, Tokk_kw_explicit, Kwd_cxx },
+	{ "co_yield", 8, 0xF874CA49, Tokk_kw_co_yield, Kwd_cxx20 },
+	{ "__attribute", 11, 0x08E95349, Tokk_kw___attribute, Kwd_c89 | Kwd_cxx },
+	{ "const", 5, 0x664FD1D4, Tokk_kw_const, Kwd_c89 | Kwd_cxx },
+	{ "import", 6, 0x112A90D4, Tokk_kw_import, Kwd_ext },
+	{ "__is_arithmetic", 15, 0xDB888054, Tokk_kw___is_arithmetic, Kwd_cxx },
+	{ "short", 5, 0xBA226BD5, Tokk_kw_short, Kwd_c89 | Kwd_cxx },
+	{ "requires", 8, 0x9B8CAA55, Tokk_kw_requires, Kwd_cxx20 },
+	{ "__is_reference", 14, 0x6385A455, Tokk_kw___is_reference, Kwd_cxx },
+	{ "__add_pointer", 13, 0xEDF98EE0, Tokk_kw___add_pointer, Kwd_cxx },
+	{ "__is_signed", 11, 0x9B7112E0, Tokk_kw___is_signed, Kwd_cxx },
+	{ "__vector", 8, 0xF8DAB8E0, Tokk_kw___vector, Kwd_ext },
+	{ "_Static_assert", 14, 0x505E61EF, Tokk_kw__Static_assert, Kwd_c89 | Kwd_cxx },
+	{ "__is_nothrow_constructible", 26, 0x1D8F156F, Tokk_kw___is_nothrow_constructible, Kwd_cxx },
+	{ "__signed", 8, 0x2B06546F, Tokk_kw_signed, Kwd_c89 | Kwd_cxx },
+	{ "else", 4, 0xBDBF5BF0, Tokk_kw_else, Kwd_c89 | Kwd_cxx },
+	{ "__is_class", 10, 0xDB20CEF0, Tokk_kw___is_class, Kwd_cxx },
+	{ "__remove_extent", 15, 0x281132F0, Tokk_kw___remove_extent, Kwd_cxx },
+	{ "const_cast", 10, 0x44E4E5F2, Tokk_kw_const_cast, Kwd_cxx },
+	{ "consteval", 9, 0xC9101B72, Tokk_kw_consteval, Kwd_cxx20 },
+	{ "__local", 7, 0x5C46D672, Tokk_kw___local, Kwd_opencl },
+	{ "union", 5, 0xDBDED6F4, Tokk_kw_union, Kwd_c89 | Kwd_cxx },
+	{ "__is_scalar", 11, 0x436317F4, Tokk_kw___is_scalar, Kwd_cxx },
+	{ "_uuidof", 7, 0x3AC52D74, Tokk_kw___uuidof, Kwd_ms },
+	{ "constexpr", 9, 0x5AA35603, Tokk_kw_constexpr, Kwd_cxx11 },
+	{ "__remove_const", 14, 0x36DD6083, Tokk_kw___remove_const, Kwd_cxx },
+	{ "__remove_volatile", 17, 0x6DB44504, Tokk_kw___remove_volatile, Kwd_cxx },
+	{ "image2d_msaa_t", 14, 0x75404D84, Tokk_kw_image2d_msaa_t, Kwd_opencl },
+	{ "if", 2, 0x39386E06, Tokk_kw_if, Kwd_c89 | Kwd_cxx },
+	{ "__is_same", 9, 0x8662EC06, Tokk_kw___is_same, Kwd_cxx },
+	{ "double", 6, 0xA0EB0F08, Tokk_kw_double, Kwd_c89 | Kwd_cxx },
+	{ "local", 5, 0x9C436708, Tokk_kw___local, Kwd_opencl },
+	{ "__is_trivially_copyable", 23, 0xF9728B8A, Tokk_kw___is_trivially_copyable, Kwd_cxx },
+	{ "image2d_array_msaa_t", 20, 0xA44CBB8A, Tokk_kw_image2d_array_msaa_t, Kwd_opencl },
+	{ "template", 8, 0x694AAA0B, Tokk_kw_template, Kwd_cxx },
+	{ "__is_lvalue_reference", 21, 0x8515178B, Tokk_kw___is_lvalue_reference, Kwd_cxx },
+	{ "__bool", 6, 0x3AC42B17, Tokk_kw___bool, Kwd_ext },
+	{ "__alignof__", 11, 0xC8788197, Tokk_kw___alignof, Kwd_c89 | Kwd_cxx },
+	{ "_Noreturn", 9, 0x3974EFA7, Tokk_kw__Noreturn, Kwd_c89 | Kwd_cxx },
+	{ "__array_rank", 12, 0xFF98B527, Tokk_kw___array_rank, Kwd_cxx },
+	{ "__builtin_available", 19, 0xBD3111AE, Tokk_kw___builtin_available, Kwd_c89 | Kwd_cxx },
+	{ "global", 6, 0x1DFF06AE, Tokk_kw___global, Kwd_opencl },
+	{ "case", 4, 0x9B2538B1, Tokk_kw_case, Kwd_c89 | Kwd_cxx },
+	{ "__has_nothrow_copy", 18, 0xBC955FB1, Tokk_kw___has_nothrow_copy, Kwd_cxx },
+	{ "__float128", 10, 0x4390B7B8, Tokk_kw___float128, Kwd_c89 | Kwd_cxx },
+	{ "__declspec", 10, 0xC60714B8, Tokk_kw___declspec, Kwd_c89 | Kwd_cxx },
+	{ "__is_lvalue_expr", 16, 0x3D8FE2B9, Tokk_kw___is_lvalue_expr, Kwd_cxx },
+	{ "groupshared", 11, 0x419E9B39, Tokk_kw_groupshared, Kwd_ext },
+	{ "_Thread_local", 13, 0x1D0E8DBE, Tokk_kw__Thread_local, Kwd_c89 | Kwd_cxx },
+	{ "__w64", 5, 0x8318D23E, Tokk_kw___w64, Kwd_ms },
+	{ "continue", 8, 0xB1727E44, Tokk_kw_continue, Kwd_c89 | Kwd_cxx },
+	{ "__bridge_transfer", 17, 0x9C457CC4, Tokk_kw___bridge_transfer, Kwd_ext },
+	{ "_Accum", 6, 0x072E6445, Tokk_kw__Accum, Kwd_c89 },
+	{ "_asm", 4, 0xA053BD45, Tokk_kw_asm, Kwd_ms },
+	{ "__imag__", 8, 0xBBD96F4B, Tokk_kw___imag, Kwd_c89 | Kwd_cxx },
+	{ "_cdecl", 6, 0xC1A7104B, Tokk_kw___cdecl, Kwd_ms },
+	{ "catch", 5, 0x4288E94C, Tokk_kw_catch, Kwd_cxx },
+	{ "__asm__", 7, 0xEAF597CC, Tokk_kw_asm, Kwd_c89 | Kwd_cxx },
+	{ "__remove_cv", 11, 0xAB8B34CD, Tokk_kw___remove_cv, Kwd_cxx },
+	{ "__int32", 7, 0x1A54EBCD, Tokk_kw_int, Kwd_ms },
+	{ "__is_nothrow_destructible", 25, 0x811924D0, Tokk_kw___is_nothrow_destructible, Kwd_ms },
+	{ "__is_standard_layout", 20, 0x38D2BB50, Tokk_kw___is_standard_layout, Kwd_cxx },
+	{ "__interface", 11, 0xD4EA8CD2, Tokk_kw___interface, Kwd_ms },
+	{ "_alignof", 8, 0xBAD607D2, Tokk_kw___alignof, Kwd_ms },
+	{ "long", 4, 0xC2ECDF53, Tokk_kw_long, Kwd_c89 | Kwd_cxx },
+	{ "__noinline__", 12, 0x268FF2D3, Tokk_kw___noinline__, Kwd_ext },
+	{ "__is_member_object_pointer", 26, 0x3772AB56, Tokk_kw___is_member_object_pointer, Kwd_cxx },
+	{ "image3d_t", 9, 0x829FC756, Tokk_kw_image3d_t, Kwd_opencl },
+	{ "noexcept", 8, 0x61338257, Tokk_kw_noexcept, Kwd_cxx11 },
+	{ "__is_nothrow_assignable", 23, 0xBFFDAF57, Tokk_kw___is_nothrow_assignable, Kwd_cxx },
+	{ "__label__", 9, 0x2A82BF59, Tokk_kw___label__, Kwd_c89 | Kwd_cxx },
+	{ "_declspec", 9, 0xF08B19D9, Tokk_kw___declspec, Kwd_ms },
+	{ "L__FUNCTION__", 13, 0xAF8D68DB, Tokk_kw_L__FUNCTION__, Kwd_ms },
+	{ "__is_const", 10, 0x4F650DDB, Tokk_kw___is_const, Kwd_cxx },
+	{ "__is_rvalue_reference", 21, 0x3408E7DD, Tokk_kw___is_rvalue_reference, Kwd_cxx },
+	{ "__signed__", 10, 0xB117CADD, Tokk_kw_signed, Kwd_c89 | Kwd_cxx },
+	{ "void", 4, 0x48B5725F, Tokk_kw_void, Kwd_c89 | Kwd_cxx },
+	{ "__bridge_retained", 17, 0x971DF25F, Tokk_kw___bridge_retained, Kwd_ext },
+	{ "__is_interface_class", 20, 0x71CD9264, Tokk_kw___is_interface_class, Kwd_ms },
+	{ "__is_integral", 13, 0xC087E7E4, Tokk_kw___is_integral, Kwd_cxx },
+	{ "goto", 4, 0xF5A30FE6, Tokk_kw_goto, Kwd_c89 | Kwd_cxx },
+	{ "__leave", 7, 0x8BAEFAE6, Tokk_kw___leave, Kwd_ms },
+	{ "__is_unsigned", 13, 0x2EC1E867, Tokk_kw___is_unsigned, Kwd_cxx },
+	{ "__read_write", 12, 0x530A8BE7, Tokk_kw___read_write, Kwd_opencl },
+	{ "__is_complete_type", 18, 0x09075968, Tokk_kw___is_complete_type, Kwd_cxx },
+	{ "_Nonnull", 8, 0xCBB280E8, Tokk_kw__Nonnull, Kwd_c89 | Kwd_cxx },
+	{ "typeof_unqual", 13, 0xEE15BD69, Tokk_kw_typeof_unqual, Kwd_c23 },
+	{ "__module_private__", 18, 0x1CDD0E69, Tokk_kw___module_private__, Kwd_c89 | Kwd_cxx },
+	{ "__is_base_of", 12, 0xEA688A77, Tokk_kw___is_base_of, Kwd_cxx },
+	{ "__is_literal", 12, 0x3D1EC3F7, Tokk_kw___is_literal, Kwd_cxx },
+	{ "this", 4, 0xDA2BD281, Tokk_kw_this, Kwd_cxx },
+	{ "__is_trivially_assignable", 25, 0x87636E82, Tokk_kw___is_trivially_assignable, Kwd_cxx },
+	{ "__is_trivial", 12, 0x74EAF789, Tokk_kw___is_trivial, Kwd_cxx },
+	{ "_Null_unspecified", 17, 0xE877BB8F, Tokk_kw__Null_unspecified, Kwd_c89 | Kwd_cxx },
+	{ "__remove_restrict", 17, 0x04CA0518, Tokk_kw___remove_restrict, Kwd_cxx },
+	{ "__remove_cvref", 14, 0x2586C11A, Tokk_kw___remove_cvref, Kwd_cxx },
+	{ "nullptr", 7, 0x0BBDE79E, Tokk_kw_nullptr, Kwd_cxx11 | Kwd_c23 },
+	{ "_Bool", 5, 0xAE76E4A2, Tokk_kw__Bool, Kwd_c89 },
+	{ "unsigned", 8, 0x0C547726, Tokk_kw_unsigned, Kwd_c89 | Kwd_cxx },
+	{ "image1d_t", 9, 0xA044602C, Tokk_kw_image1d_t, Kwd_opencl },
+	{ "__make_signed", 13, 0x6C0243B6, Tokk_kw___make_signed, Kwd_cxx },
+	{ "__extension__", 13, 0xDD4F66BA, Tokk_kw___extension__, Kwd_c89 | Kwd_cxx },
+	{ "bool", 4, 0xC894953D, Tokk_kw_bool, Kwd_cxx | Kwd_c23 | Kwd_opencl },
+	{ "return", 6, 0x85EE37BF, Tokk_kw_return, Kwd_c89 | Kwd_cxx },
+	{ "__pixel", 7, 0x79D53641, Tokk_kw___pixel, Kwd_ext },
+	{ "__complex__", 11, 0x2A53A7CF, Tokk_kw__Complex, Kwd_c89 | Kwd_cxx },
+	{ "__bridge", 8, 0x2D59E8DA, Tokk_kw___bridge, Kwd_ext },
+	{ "__inline", 8, 0x1A3AA9EA, Tokk_kw_inline, Kwd_c89 | Kwd_cxx },
+	{ "__const", 7, 0xEF1030EE, Tokk_kw_const, Kwd_c89 | Kwd_cxx },
+	{ "__builtin_astype", 16, 0x89174AF3, Tokk_kw___builtin_astype, Kwd_opencl },
+	{ "break", 5, 0xC9648178, Tokk_kw_break, Kwd_c89 | Kwd_cxx },
+	{ "__has_nothrow_move_assign", 25, 0xA1DBC97B, Tokk_kw___has_nothrow_move_assign, Kwd_cxx },
+	{ "__has_trivial_constructor", 25, 0x0316647C, Tokk_kw___has_trivial_constructor, Kwd_cxx },
+};
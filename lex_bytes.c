@@ -0,0 +1,228 @@
+// lex_bytes.c : lex files through ctok.lib (Lex_bytes and a visitor), printing tokens
+//  exactly like ctok.exe does, so test.py can hold the library to the same clang output.
+//  Built as C, against nothing but ctok.h, to keep the header honest.
+
+// lex_bytes [-std=...] [--columns=bytes|codepoints|utf16] [--arena-cap=<bytes>] <file>...
+
+// Every file goes through one arena, like a long running user would. --arena-cap
+//  sets Arena_t::block_cap_max, so a big enough file runs out of memory on purpose.
+//  Unlike ctok.exe, running out is not fatal, we say so and go on to the next file
+//  (with the same arena), to check Lex_bytes leaves it fit to use again.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <wchar.h>
+
+#include "ctok.h"
+
+typedef struct Visit_ctx_t
+{
+	const uint8_t * bytes;
+} Visit_ctx_t;
+
+void Print_byte_escaped(uint8_t byte)
+{
+	// Same escapes as ctok.exe
+
+	switch (byte)
+	{
+	case '"':
+		printf("\\\"");
+		return;
+
+	case '\\':
+		printf("\\\\");
+		return;
+
+	case '\f':
+		printf("\\f");
+		return;
+
+	case '\n':
+		printf("\\n");
+		return;
+
+	case '\r':
+		printf("\\r");
+		return;
+
+	case '\t':
+		printf("\\t");
+		return;
+
+	case '\v':
+		printf("\\v");
+		return;
+
+	default:
+		break;
+	}
+
+	if (byte > ' ' && byte < 0x7F)
+	{
+		printf("%c", byte);
+	}
+	else
+	{
+		printf("\\x%02X", byte);
+	}
+}
+
+void Visit_token(
+	void * user_r,
+	Tokk_t tokk,
+	uint32_t off_begin,
+	uint32_t off_end,
+	uint32_t line,
+	uint32_t col)
+{
+	const Visit_ctx_t * ctx_r = (const Visit_ctx_t *)user_r;
+
+	printf("%s \"", Str_from_tokk(tokk));
+
+	for (uint32_t off = off_begin; off < off_end; ++off)
+	{
+		Print_byte_escaped(ctx_r->bytes[off]);
+	}
+
+	printf("\" %u:%u\n", line, col);
+}
+
+bool Try_read_file(
+	const wchar_t * path,
+	uint8_t ** bytes_r,
+	size_t * len_r)
+{
+	FILE * file = _wfopen(path, L"rb");
+	if (!file)
+		return false;
+
+	// get file length
+	//  (seek to end, ftell, seek back to start)
+
+	long signed_len = -1;
+	if (fseek(file, 0, SEEK_END) == 0)
+	{
+		signed_len = ftell(file);
+	}
+
+	if (signed_len < 0 || fseek(file, 0, SEEK_SET) != 0)
+	{
+		fclose(file);
+		return false;
+	}
+
+	size_t len = (size_t)signed_len;
+
+	// malloc(0) may return NULL, so always ask for at least a byte
+
+	uint8_t * bytes = (uint8_t *)malloc(len ? len : 1);
+	if (!bytes || fread(bytes, 1, len, file) != len)
+	{
+		free(bytes);
+		fclose(file);
+		return false;
+	}
+
+	fclose(file);
+
+	*bytes_r = bytes;
+	*len_r = len;
+	return true;
+}
+
+int wmain(int argc, wchar_t *argv[])
+{
+	Lex_opts_t opts = {Lang_c11, false, Col_unit_bytes};
+	Arena_t arena = {0};
+
+	for (int i_arg = 1; i_arg < argc; ++i_arg)
+	{
+		wchar_t * arg = argv[i_arg];
+
+		if (wcscmp(arg, L"-std=c89") == 0)
+		{
+			opts.lang = Lang_c89;
+		}
+		else if (wcscmp(arg, L"-std=c11") == 0)
+		{
+			opts.lang = Lang_c11;
+		}
+		else if (wcscmp(arg, L"-std=c23") == 0 || wcscmp(arg, L"-std=c2x") == 0)
+		{
+			opts.lang = Lang_c23;
+		}
+		else if (wcscmp(arg, L"-std=c++17") == 0)
+		{
+			opts.lang = Lang_cxx17;
+		}
+		else if (wcscmp(arg, L"-std=c++20") == 0)
+		{
+			opts.lang = Lang_cxx20;
+		}
+		else if (wcscmp(arg, L"--columns=bytes") == 0)
+		{
+			opts.col_unit = Col_unit_bytes;
+		}
+		else if (wcscmp(arg, L"--columns=codepoints") == 0)
+		{
+			opts.col_unit = Col_unit_codepoints;
+		}
+		else if (wcscmp(arg, L"--columns=utf16") == 0)
+		{
+			opts.col_unit = Col_unit_utf16;
+		}
+		else if (wcsncmp(arg, L"--arena-cap=", 12) == 0)
+		{
+			arena.block_cap_max = (size_t)wcstoull(arg + 12, NULL, 10);
+		}
+		else if (arg[0] == L'-')
+		{
+			printf(
+				"unexpected option '%ls'\n",
+				arg);
+
+			return 1;
+		}
+	}
+
+	int exit_code = 0;
+
+	for (int i_arg = 1; i_arg < argc; ++i_arg)
+	{
+		wchar_t * path = argv[i_arg];
+		if (path[0] == L'-')
+			continue;
+
+		uint8_t * bytes;
+		size_t len;
+		if (!Try_read_file(path, &bytes, &len))
+		{
+			printf(
+				"Failed to read file '%ls'.\n",
+				path);
+
+			return 1;
+		}
+
+		Visit_ctx_t ctx = {bytes};
+		if (!Lex_bytes(&opts, &arena, bytes, len, Visit_token, &ctx))
+		{
+			// Out of memory (or too big), after visiting any tokens before that
+
+			printf(
+				"Lex_bytes failed on '%ls'.\n",
+				path);
+
+			exit_code = 1;
+		}
+
+		free(bytes);
+	}
+
+	Free_arena(&arena);
+
+	return exit_code;
+}
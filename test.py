@@ -1,5 +1,6 @@
 
 import os
+import re
 import subprocess
 import shutil
 import concurrent.futures
@@ -26,8 +27,56 @@ scrub_ws_path = f"{ignored_by_git_dir}/build/exe/scrub_ws.exe"
 no_hashtag_test_files_in = "test_files/no_hashtag"
 no_hashtag_test_files_out = f"{ignored_by_git_dir}/test_output/no_hashtag"
 
+# clang -dump-tokens expands predefined macros (__FILE__ and co.), ctok never does
+
+no_hashtag_skips = [
+	'tinycc-release_0_9_27/tests/tcctest.h',
+]
+
+# --columns= is checked against a conversion of the byte columns (see col_from_byte_col),
+#  over every test file with a non-ascii byte in it. There are no CRLF or BOM files
+#  in test_files, so we also check a CRLF copy and a BOM copy of each of those
+
+column_test_files_out = f"{ignored_by_git_dir}/column_test_files"
+column_test_units = ['codepoints', 'utf16']
+column_test_copies = ['crlf', 'bom']
+
+utf8_bom = b'\xEF\xBB\xBF'
+
 ctok_exe = f"{ignored_by_git_dir}/build/exe/ctok.exe"
 
+# lex_bytes.exe prints the same tokens, but lexes through ctok.lib (see lex_bytes.c).
+#  Capping its arena this low makes the biggest test file run out of memory
+
+lex_bytes_exe = f"{ignored_by_git_dir}/build/exe/lex_bytes.exe"
+lex_bytes_oom_arena_cap = 64 * 1024
+
+# Every isa and every way of lexing has to give byte identical output,
+#  so we check each of them against the same clang output
+
+ctok_variants = [
+	[],
+	['--isa=scalar'],
+	['--isa=sse2'],
+	['--isa=avx2'],
+	['--isa=avx512'],
+	['--lazy'],
+	['--peek'],
+	['--sparse'],
+]
+
+# Each -std= ctok knows, with what clang needs to lex the same way
+#  (clang 17 still calls C23 c2x). c11 is the default, and the only one
+#  we run every variant for, the others just check the lexer itself
+
+test_stds = [
+	('c11', '-std=c11 -x c'),
+	('c89', '-std=c89 -x c'),
+	('c23', '-std=c2x -x c'),
+	('c++17', '-std=c++17 -x c++'),
+	('c++20', '-std=c++20 -x c++'),
+]
+
 def main():
 	if not os.path.exists(ignored_by_git_dir):
 		os.mkdir(ignored_by_git_dir)
@@ -69,6 +118,9 @@ def setup_tests():
 		#os.mkdir(raw_test_files_scrubbed)
 		scrub_raw_input()
 
+	if not os.path.exists(column_test_files_out):
+		copy_column_test_files()
+
 	ensure_test_output()
 
 def scrub_raw_input():
@@ -96,28 +148,63 @@ def scrub_ws_in_file(src_file):
 	subprocess.run(f'{scrub_exe} "{src_file}" "{src_file}"')
 	print(f'scrub_ws {src_file}')
 
+def column_test_files():
+	for root, _, fnames in os.walk(raw_test_files_in):
+		for fname in fnames:
+			path = os.path.join(root, fname)
+			with open(path, 'rb') as f:
+				data = f.read()
+			if not data.isascii():
+				yield (path, data)
+
+def copy_column_test_files():
+	print("copy_column_test_files")
+
+	for path, data in column_test_files():
+		rel_path = os.path.relpath(path, raw_test_files_in)
+		for copy_name in column_test_copies:
+			out_path = os.path.join(column_test_files_out, copy_name, rel_path)
+			directory = os.path.dirname(out_path)
+			if not os.path.exists(directory):
+				os.makedirs(directory)
+			with open(out_path, 'wb') as f:
+				if copy_name == 'crlf':
+					f.write(re.sub(rb'\r?\n', b'\r\n', data))
+				elif data.startswith(utf8_bom):
+					f.write(data)
+				else:
+					f.write(utf8_bom + data)
+
+def column_test_cases():
+	for path, _ in column_test_files():
+		yield os.path.abspath(path)
+		rel_path = os.path.relpath(path, raw_test_files_in)
+		for copy_name in column_test_copies:
+			yield os.path.abspath(os.path.join(column_test_files_out, copy_name, rel_path))
+
 def ensure_test_output():
 	# generate test/output
 	# NOTE(matthewd) clang is a little heavy weight, so we limit to 19 workers
 
 	with concurrent.futures.ThreadPoolExecutor(max_workers=19) as executor: 
 		clang = os.path.abspath(llvm_clang_exe)
-		for in_path, out_path in raw_test_cases():
-			if not os.path.isfile(out_path):
-				directory = os.path.dirname(out_path)
-				if not os.path.exists(directory):
-					os.makedirs(directory)
-				executor.submit(run_clang, clang, True, in_path, out_path)
+		for std, clang_std_args in test_stds:
+			for in_path, out_path in raw_test_cases(std):
+				if not os.path.isfile(out_path):
+					directory = os.path.dirname(out_path)
+					if not os.path.exists(directory):
+						os.makedirs(directory)
+					executor.submit(run_clang, clang, True, clang_std_args, in_path, out_path)
 		for in_path, out_path in no_hashtag_test_cases():
 			if not os.path.isfile(out_path):
 				directory = os.path.dirname(out_path)
 				if not os.path.exists(directory):
 					os.makedirs(directory)
-				executor.submit(run_clang, clang, False, in_path, out_path)
+				executor.submit(run_clang, clang, False, test_stds[0][1], in_path, out_path)
 
-def raw_test_cases():
+def raw_test_cases(std):
 	in_dir = os.path.abspath(raw_test_files_scrubbed)
-	out_dir = os.path.abspath(raw_test_files_out)
+	out_dir = os.path.abspath(f'{raw_test_files_out}/{std}')
 	for root, _, files in os.walk(in_dir):
 		for fname in files:
 			in_path = os.path.join(root, fname)
@@ -135,52 +222,91 @@ def no_hashtag_test_cases():
 		for fname in files:
 			in_path = os.path.join(root, fname)
 			rel_path = os.path.relpath(in_path, in_dir)
+			if rel_path.replace('\\', '/') in no_hashtag_skips:
+				continue
 			
 			out_path = os.path.join(out_dir, rel_path)
 			out_path += ".tokens"
 
 			yield (in_path, out_path)
 
-def run_clang(clang_path, raw, in_path, out_path):
+def run_clang(clang_path, raw, std_args, in_path, out_path):
 	with open(out_path, "wb") as out_f:
 		cmd = '-dump-raw-tokens' if raw else '-dump-tokens'
 		subprocess.run(
-			f'{clang_path} -cc1 {cmd} -std=c11 -x c "{in_path}"', 
+			f'{clang_path} -cc1 {cmd} {std_args} "{in_path}"', 
 			stderr=out_f)
 	print(f'run_clang {in_path}')
 
+def supported_ctok_variants(ctok_path):
+	# Skip any --isa= this cpu does not have (ctok refuses to run those)
+
+	variants = []
+	for variant in ctok_variants:
+		args = ' '.join(variant)
+		result = subprocess.run(
+			f'{ctok_path} {args} "{os.path.abspath(__file__)}"',
+			capture_output=True)
+		if result.returncode == 0:
+			variants.append(variant)
+		else:
+			print(f'skipping {args} : {result.stdout.decode().strip()}')
+	return variants
+
 def run_tests():
 	fails = []
 	fail_lock = Lock()
 
+	ctok = os.path.abspath(ctok_exe)
+	variants = supported_ctok_variants(ctok)
+	lex_bytes = os.path.abspath(lex_bytes_exe)
+
 	with concurrent.futures.ThreadPoolExecutor() as executor:
-		ctok = os.path.abspath(ctok_exe)
-		for in_path, out_path in raw_test_cases():
-			executor.submit(
-						run_ctok, 
-						ctok, 
-						in_path, 
-						out_path,
-						fails,
-						fail_lock)
+		for std, _ in test_stds:
+			std_variants = variants if std == test_stds[0][0] else [[]]
+			for in_path, out_path in raw_test_cases(std):
+				for variant in std_variants:
+					executor.submit(
+								run_ctok, 
+								ctok, 
+								[f'-std={std}'] + variant,
+								in_path, 
+								out_path,
+								fails,
+								fail_lock)
+				executor.submit(
+							run_ctok, 
+							lex_bytes, 
+							[f'-std={std}'],
+							in_path, 
+							out_path,
+							fails,
+							fail_lock)
 			
-		""" # todo run lex tests
-		for in_path, out_path in lex_test_cases():
-			if in_path in skips:
-				continue
+		# With keywords on, ctok prints what clang -dump-tokens does
+		#  (no whitespace or comments, then eof). These files have no '#',
+		#  so there are no directives for the preprocessor to act on.
+
+		for in_path, out_path in no_hashtag_test_cases():
 			executor.submit(
 						run_ctok, 
 						ctok, 
-						False,
+						[f'-std={test_stds[0][0]}', '--keywords'],
 						in_path, 
 						out_path,
 						fails,
 						fail_lock)
-		"""
+
+		executor.submit(run_lex_bytes_oom, lex_bytes, fails, fail_lock)
+
+		for in_path in column_test_cases():
+			for exe in [ctok, lex_bytes]:
+				executor.submit(run_ctok_columns, exe, in_path, fails, fail_lock)
 	
 	print(f'{len(fails)} tests failed')
 	if fails:
-		clang_out_path, ctok_out = fails[0]
+		clang_out_path, ctok_out, variant = fails[0]
+		print(f'first fail was {" ".join(variant)}')
 
 		temp_file = tempfile.NamedTemporaryFile(mode='w+b', delete=False)
 		temp_file.write(ctok_out)
@@ -192,9 +318,10 @@ def run_tests():
 		print(bcomapre_cmd)
 		subprocess.run(bcomapre_cmd)
 
-def run_ctok(ctok_path, in_path, out_path, fails, fail_lock):
+def run_ctok(ctok_path, variant, in_path, out_path, fails, fail_lock):
+	args = ' '.join(variant)
 	result = subprocess.run(
-		f'{ctok_path} "{in_path}"', 
+		f'{ctok_path} {args} "{in_path}"', 
 		capture_output=True)
 	ctok_out = result.stdout
 
@@ -204,7 +331,108 @@ def run_ctok(ctok_path, in_path, out_path, fails, fail_lock):
 
 	if clang_out != ctok_out:
 		with fail_lock:
-			fails.append((out_path, ctok_out))
-	print(f'run_ctok {in_path}')
+			fails.append((out_path, ctok_out, [os.path.basename(ctok_path)] + variant))
+	print(f'run_ctok {os.path.basename(ctok_path)} {args} {in_path}')
+
+def line_starts_from_bytes(data):
+	# Same line breaks as ctok (\n, \r\n or a lone \r), and line 1 starts after any BOM
+
+	starts = [len(utf8_bom) if data.startswith(utf8_bom) else 0]
+	for line_break in re.finditer(rb'\r\n|\r|\n', data):
+		starts.append(line_break.end())
+	return starts
+
+def col_from_byte_col(line_bytes, col_unit):
+	# ctok decodes invalid bytes one at a time, as one code point each,
+	#  which is what surrogateescape does too. Astral chars are two utf16 units
+
+	line_str = line_bytes.decode('utf-8', 'surrogateescape')
+	col = len(line_str) + 1
+	if col_unit == 'utf16':
+		col += sum(1 for ch in line_str if ord(ch) >= 0x10000)
+	return col
+
+def run_ctok_columns(ctok_path, in_path, fails, fail_lock):
+	# Every token has to be where the byte columns say, just counted in other units
+
+	with open(in_path, 'rb') as in_f:
+		data = in_f.read()
+	line_starts = line_starts_from_bytes(data)
+
+	bytes_out = subprocess.run(
+		f'{ctok_path} "{in_path}"', 
+		capture_output=True).stdout
+
+	for col_unit in column_test_units:
+		expected_lines = []
+		for token_line in bytes_out.splitlines(keepends=True):
+			# Token text never has a raw space in it (see Print_token_buf)
+
+			match = re.fullmatch(rb'(.*) (\d+):(\d+)(\r?\n)', token_line, re.DOTALL)
+			if not match:
+				expected_lines.append(b'<no line:col> ' + token_line)
+				continue
+
+			line = int(match[2])
+			byte_col = int(match[3])
+
+			line_start = line_starts[line - 1]
+			line_bytes = data[line_start:line_start + byte_col - 1]
+			col = col_from_byte_col(line_bytes, col_unit)
+
+			expected_lines.append(match[1] + f' {line}:{col}'.encode() + match[4])
+		expected_out = b''.join(expected_lines)
+
+		variant = [f'--columns={col_unit}']
+		ctok_out = subprocess.run(
+			f'{ctok_path} {" ".join(variant)} "{in_path}"', 
+			capture_output=True).stdout
+
+		if ctok_out != expected_out:
+			temp_file = tempfile.NamedTemporaryFile(mode='w+b', suffix='.tokens', delete=False)
+			temp_file.write(expected_out)
+			temp_file.close()
+
+			with fail_lock:
+				fails.append((temp_file.name, ctok_out, [os.path.basename(ctok_path)] + variant))
+	print(f'run_ctok_columns {os.path.basename(ctok_path)} {in_path}')
+
+def run_lex_bytes_oom(lex_bytes_path, fails, fail_lock):
+	# Lex the biggest test file with a capped arena, so Lex_bytes runs out of memory
+	#  (and longjmps out of the lexer), then a small file with the same arena.
+	#  Any tokens from before running out have to match clang, and the small
+	#  file has to come out whole.
+
+	cases = sorted(
+				raw_test_cases(test_stds[0][0]), 
+				key=lambda case: os.path.getsize(case[0]))
+
+	big_in_path, big_out_path = cases[-1]
+	small_in_path, small_out_path = cases[len(cases) // 10]
+
+	variant = [f'--arena-cap={lex_bytes_oom_arena_cap}']
+	result = subprocess.run(
+		f'{lex_bytes_path} {" ".join(variant)} "{big_in_path}" "{small_in_path}"', 
+		capture_output=True)
+	lex_bytes_out = result.stdout
+
+	with open(big_out_path, 'rb') as clang_o:
+		big_clang_out = clang_o.read()
+
+	with open(small_out_path, 'rb') as clang_o:
+		small_clang_out = clang_o.read()
+
+	fail_line = f"Lex_bytes failed on '{big_in_path}'.".encode()
+	i_fail = lex_bytes_out.find(fail_line)
+	i_rest = lex_bytes_out.find(b'\n', i_fail) + 1
+
+	ok = (i_fail >= 0 and 
+		big_clang_out.startswith(lex_bytes_out[:i_fail]) and
+		lex_bytes_out[i_rest:] == small_clang_out)
+
+	if not ok:
+		with fail_lock:
+			fails.append((big_out_path, lex_bytes_out, [os.path.basename(lex_bytes_path)] + variant))
+	print(f'run_lex_bytes_oom {big_in_path} {small_in_path}')
 
 main()
\ No newline at end of file